@@ -0,0 +1,60 @@
+// Replacement of the global allocation functions for the memory benchmarks.
+// Counting is only active between start_counting_allocations() and
+// stop_counting_allocations() so the timing benchmarks are not affected.
+
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+namespace {
+
+thread_local bool counting = false;
+thread_local bencode::benchmark::allocation_count counts {};
+
+void* counted_allocate(std::size_t size)
+{
+    if (counting) {
+        ++counts.allocations;
+        counts.bytes += size;
+    }
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+namespace bencode::benchmark {
+
+void start_counting_allocations() noexcept
+{
+    counts = {};
+    counting = true;
+}
+
+allocation_count stop_counting_allocations() noexcept
+{
+    counting = false;
+    return counts;
+}
+
+} // namespace bencode::benchmark
+
+void* operator new(std::size_t size)
+{ return counted_allocate(size); }
+
+void* operator new[](std::size_t size)
+{ return counted_allocate(size); }
+
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p, std::size_t) noexcept
+{ std::free(p); }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+/// @file Counts calls to the global allocation functions of the benchmark executable.
+
+namespace bencode::benchmark {
+
+struct allocation_count
+{
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+};
+
+/// Start counting allocations of the calling thread.
+void start_counting_allocations() noexcept;
+
+/// Stop counting and return the allocations since the last call to start_counting_allocations().
+allocation_count stop_counting_allocations() noexcept;
+
+} // namespace bencode::benchmark
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "bencode/detail/parser/common.hpp"
+
+/// @file Input documents shared by the benchmarks.
+
+namespace bencode::benchmark {
+
+/// Parser options without value limit for the large synthetic documents.
+inline constexpr parser_options unlimited_options {
+    .recursion_limit = 4096,
+    .value_limit = std::numeric_limits<std::uint32_t>::max(),
+};
+
+/// Read a file from the benchmark resources directory.
+inline std::string load_resource(std::string_view name)
+{
+    std::ifstream ifs(fmt::format("{}/{}", RESOURCES_DIR, name), std::ios::binary);
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+inline const std::string& fedora_torrent()
+{
+    static const auto data = load_resource("Fedora-Workstation-Live-x86_64-30.torrent");
+    return data;
+}
+
+inline const std::string& nasa_torrent()
+{
+    static const auto data = load_resource("NASA-Viking-Merged-Color-Mosaic.torrent");
+    return data;
+}
+
+inline const std::string& covid_torrent()
+{
+    static const auto data = load_resource("COVID-19-image-dataset-collection.torrent");
+    return data;
+}
+
+/// Lists nested depth levels deep around a single integer: "lll...i1e...eee".
+inline std::string make_deep_nesting(std::size_t depth)
+{
+    std::string out(depth, 'l');
+    out += "i1e";
+    out.append(depth, 'e');
+    return out;
+}
+
+/// A dict with n members with sorted keys "key000000", "key000001", ... and integer values.
+inline std::string make_wide_dict(std::size_t n)
+{
+    std::string out = "d";
+    for (std::size_t i = 0; i < n; ++i) {
+        fmt::format_to(std::back_inserter(out), "9:key{:06d}i{}e", i, i);
+    }
+    out += "e";
+    return out;
+}
+
+/// A single string of given size.
+inline std::string make_huge_string(std::size_t size)
+{
+    auto out = fmt::format("{}:", size);
+    out.append(size, 'x');
+    return out;
+}
+
+/// A list with n small integers.
+inline std::string make_integer_list(std::size_t n)
+{
+    std::string out = "l";
+    for (std::size_t i = 0; i < n; ++i) {
+        fmt::format_to(std::back_inserter(out), "i{}e", i % 100);
+    }
+    out += "e";
+    return out;
+}
+
+/// A DHT get_peers response (BEP 5) with eight compact nodes and eight peers.
+inline std::string make_dht_message()
+{
+    std::string out = "d1:rd2:id20:";
+    out.append(20, 'i');
+    out += "5:nodes208:";
+    out.append(208, 'n');
+    out += "5:token8:aoeusnth6:valuesl";
+    for (int i = 0; i < 8; ++i) out += "6:axje.u";
+    out += "ee1:t2:aa1:y1:re";
+    return out;
+}
+
+} // namespace bencode::benchmark
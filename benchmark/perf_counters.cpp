@@ -0,0 +1,156 @@
+#include "perf_counters.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+namespace bencode::benchmark {
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr std::array<std::uint64_t, 4> counter_configs = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES,
+};
+
+int open_counter(std::uint64_t config, int group_fd)
+{
+    perf_event_attr attr {};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+
+perf_counters::perf_counters()
+{
+    for (std::size_t i = 0; i < counter_configs.size(); ++i) {
+        fds_[i] = open_counter(counter_configs[i], group_fd_);
+        if (fds_[i] == -1) {
+            reason_ = fmt::format("perf_event_open failed: {}", std::strerror(errno));
+            for (std::size_t j = 0; j < i; ++j) {
+                close(fds_[j]);
+                fds_[j] = -1;
+            }
+            group_fd_ = -1;
+            return;
+        }
+        if (i == 0) group_fd_ = fds_[0];
+    }
+}
+
+perf_counters::~perf_counters()
+{
+    for (int fd : fds_) {
+        if (fd != -1) close(fd);
+    }
+}
+
+void perf_counters::start() noexcept
+{
+    if (!available()) return;
+    ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+perf_counter_values perf_counters::stop() noexcept
+{
+    if (!available()) return {};
+    ioctl(group_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP: number of counters followed by the counter values
+    std::array<std::uint64_t, 1 + counter_configs.size()> buffer {};
+    if (read(group_fd_, buffer.data(), sizeof(buffer)) != sizeof(buffer)) return {};
+    return {
+        .cycles = buffer[1],
+        .instructions = buffer[2],
+        .branch_misses = buffer[3],
+        .cache_misses = buffer[4],
+    };
+}
+
+#else
+
+perf_counters::perf_counters()
+        : reason_("hardware counters require Linux perf_event_open")
+{}
+
+perf_counters::~perf_counters() = default;
+
+void perf_counters::start() noexcept {}
+
+perf_counter_values perf_counters::stop() noexcept
+{ return {}; }
+
+#endif
+
+
+namespace {
+
+struct benchmark_counter_state
+{
+    perf_counters counters {};
+    std::uint64_t calls = 0;
+    std::optional<perf_counter_values> totals = std::nullopt;
+};
+
+benchmark_counter_state& benchmark_state()
+{
+    static benchmark_counter_state state {};
+    return state;
+}
+
+} // namespace
+
+void detail::stop_benchmark_counters() noexcept
+{
+    auto& state = benchmark_state();
+    state.totals = state.counters.stop();
+}
+
+void start_benchmark_counters(std::uint64_t calls) noexcept
+{
+    auto& state = benchmark_state();
+    state.calls = calls;
+    state.totals = std::nullopt;
+    if (!state.counters.available() || calls == 0) return;
+
+    detail::benchmark_calls_left = calls;
+    state.counters.start();
+}
+
+std::optional<benchmark_counter_values> finish_benchmark_counters() noexcept
+{
+    auto& state = benchmark_state();
+    const auto bytes_per_call = std::exchange(detail::benchmark_bytes_per_call, 0);
+    if (!state.counters.available()) return std::nullopt;
+
+    // the body did not count its calls, the counters also ran during the analysis
+    if (detail::benchmark_calls_left != 0) {
+        detail::benchmark_calls_left = 0;
+        state.counters.stop();
+        return std::nullopt;
+    }
+    if (!state.totals) return std::nullopt;
+    return benchmark_counter_values{
+            .totals = *state.totals, .calls = state.calls, .bytes_per_call = bytes_per_call};
+}
+
+} // namespace bencode::benchmark
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#ifndef CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#endif
+#include <catch2/catch.hpp>
+
+/// @file Hardware performance counters read through Linux perf_event_open.
+
+namespace bencode::benchmark {
+
+/// Counter values of one measurement.
+struct perf_counter_values
+{
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t branch_misses = 0;
+    std::uint64_t cache_misses = 0;
+};
+
+/// A group of hardware counters for the calling thread, counting user space only.
+///
+/// When the counters cannot be opened, because the platform is not Linux, the kernel does not
+/// expose them (virtual machines, containers) or perf_event_paranoid forbids access,
+/// available() returns false and unavailable_reason() describes why.
+/// Measurements are then no-ops returning zero values.
+class perf_counters
+{
+public:
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available() const noexcept
+    { return group_fd_ != -1; }
+
+    const std::string& unavailable_reason() const noexcept
+    { return reason_; }
+
+    /// Reset and enable the counters.
+    void start() noexcept;
+
+    /// Disable the counters and return the counts since start().
+    perf_counter_values stop() noexcept;
+
+private:
+    int group_fd_ = -1;
+    std::array<int, 4> fds_ = {-1, -1, -1, -1};
+    std::string reason_ {};
+};
+
+
+// Hardware counters of BENCHMARK cases.
+//
+// The csv and json reporters start the counters when Catch starts sampling a benchmark.
+// Benchmark bodies declared with BENCODE_BENCHMARK count their calls and stop the counters
+// after the last sampled call, before Catch analyses the samples.
+// BENCODE_BENCHMARK_BYTES also records the number of input bytes processed per call.
+
+/// Counter values of the sampled calls of a benchmark.
+struct benchmark_counter_values
+{
+    perf_counter_values totals {};
+    std::uint64_t calls = 0;
+    /// Input bytes processed per call, 0 when unknown.
+    std::uint64_t bytes_per_call = 0;
+
+    double per_call(std::uint64_t perf_counter_values::* counter) const noexcept
+    { return calls == 0 ? 0.0 : static_cast<double>(totals.*counter) / static_cast<double>(calls); }
+
+    double per_byte(std::uint64_t perf_counter_values::* counter) const noexcept
+    {
+        return bytes_per_call == 0 ? 0.0
+                : per_call(counter) / static_cast<double>(bytes_per_call);
+    }
+};
+
+namespace detail {
+
+/// Number of sampled calls left until the counters of the running benchmark stop.
+inline thread_local std::uint64_t benchmark_calls_left = 0;
+
+/// Input bytes processed per call by the benchmark declared last.
+inline thread_local std::uint64_t benchmark_bytes_per_call = 0;
+
+void stop_benchmark_counters() noexcept;
+
+} // namespace detail
+
+/// Start the benchmark counters for the given number of sampled calls.
+void start_benchmark_counters(std::uint64_t calls) noexcept;
+
+/// Returns the counter values of the benchmark started last, or std::nullopt when the counters
+/// are unavailable or the benchmark body does not count its calls.
+std::optional<benchmark_counter_values> finish_benchmark_counters() noexcept;
+
+/// Called after every call of a counted benchmark body.
+inline void count_benchmark_call() noexcept
+{
+    if (detail::benchmark_calls_left != 0 && --detail::benchmark_calls_left == 0) [[unlikely]]
+        detail::stop_benchmark_counters();
+}
+
+struct counted_benchmark_tag
+{
+    std::uint64_t bytes_per_call = 0;
+};
+
+/// Wraps a benchmark body to count its calls.
+template <typename F>
+auto operator->*(counted_benchmark_tag tag, F&& f)
+{
+    detail::benchmark_bytes_per_call = tag.bytes_per_call;
+    return [f = std::forward<F>(f)](int index) {
+        struct count_on_exit
+        {
+            ~count_on_exit() { count_benchmark_call(); }
+        } guard {};
+        return f(index);
+    };
+}
+
+} // namespace bencode::benchmark
+
+
+#define BENCODE_BENCHMARK_IMPL(benchmark_name, name, bytes) \
+    if (Catch::Benchmark::Benchmark benchmark_name {name}) \
+        benchmark_name = ::bencode::benchmark::counted_benchmark_tag {static_cast<std::uint64_t>(bytes)} \
+                ->* [&]([[maybe_unused]] int benchmark_index)
+
+/// Declares a Catch BENCHMARK of which the csv and json reporters record hardware counters.
+#define BENCODE_BENCHMARK(name) \
+    BENCODE_BENCHMARK_IMPL(INTERNAL_CATCH_UNIQUE_NAME(bencode_benchmark_), name, 0)
+
+/// Declares a BENCODE_BENCHMARK processing the given number of input bytes per call,
+/// the csv and json reporters also record the hardware counters per byte.
+#define BENCODE_BENCHMARK_BYTES(name, bytes) \
+    BENCODE_BENCHMARK_IMPL(INTERNAL_CATCH_UNIQUE_NAME(bencode_benchmark_), name, bytes)
@@ -0,0 +1,237 @@
+// Machine readable reporters for benchmark results.
+//
+// Select with the reporter option of the benchmark executable:
+//     bencode-benchmark -r csv -o results.csv
+//     bencode-benchmark -r json -o results.json
+//
+// Every benchmark produces one record with the test case, the section path,
+// the benchmark name and the sample statistics in nanoseconds.
+// Benchmarks declared with BENCODE_BENCHMARK also record cycles, instructions, branch misses
+// and cache misses per call when hardware counters are available, the fields are empty otherwise.
+// Benchmarks declared with BENCODE_BENCHMARK_BYTES record the same counters per input byte.
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "bencode/detail/json_escape.hpp"
+
+#include "perf_counters.hpp"
+
+namespace {
+
+struct benchmark_record
+{
+    std::string test_case;
+    std::string section;
+    std::string name;
+    int samples;
+    int iterations;
+    double mean;
+    double mean_lower_bound;
+    double mean_upper_bound;
+    double standard_deviation;
+    double outlier_variance;
+    std::optional<bencode::benchmark::benchmark_counter_values> counters;
+};
+
+/// Collects a benchmark_record for every benchmark and writes them when the run ends.
+template <typename Derived>
+class record_reporter : public Catch::StreamingReporterBase<Derived>
+{
+    using base = Catch::StreamingReporterBase<Derived>;
+
+public:
+    using base::base;
+
+    void assertionStarting(const Catch::AssertionInfo&) override {}
+
+    bool assertionEnded(const Catch::AssertionStats&) override
+    { return true; }
+
+    void benchmarkStarting(const Catch::BenchmarkInfo& info) override
+    {
+        base::benchmarkStarting(info);
+        bencode::benchmark::start_benchmark_counters(
+                static_cast<std::uint64_t>(info.samples) * static_cast<std::uint64_t>(info.iterations));
+    }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+    {
+        auto counters = bencode::benchmark::finish_benchmark_counters();
+
+        std::string section {};
+        // the first section is the test case itself
+        for (std::size_t i = 1; i < this->m_sectionStack.size(); ++i) {
+            if (!section.empty()) section += '/';
+            section += this->m_sectionStack[i].name;
+        }
+        records_.push_back({
+                .test_case = this->currentTestCaseInfo->name,
+                .section = std::move(section),
+                .name = stats.info.name,
+                .samples = stats.info.samples,
+                .iterations = stats.info.iterations,
+                .mean = stats.mean.point.count(),
+                .mean_lower_bound = stats.mean.lower_bound.count(),
+                .mean_upper_bound = stats.mean.upper_bound.count(),
+                .standard_deviation = stats.standardDeviation.point.count(),
+                .outlier_variance = stats.outlierVariance,
+                .counters = counters,
+        });
+    }
+
+    void testRunEnded(const Catch::TestRunStats& stats) override
+    {
+        static_cast<Derived*>(this)->write(records_);
+        this->stream.flush();
+        base::testRunEnded(stats);
+    }
+
+private:
+    std::vector<benchmark_record> records_ {};
+};
+
+
+using bencode::benchmark::perf_counter_values;
+
+/// Returns the hardware counters per call in the order cycles, instructions,
+/// branch misses and cache misses.
+std::array<double, 4> counters_per_call(const bencode::benchmark::benchmark_counter_values& c)
+{
+    return {
+        c.per_call(&perf_counter_values::cycles),
+        c.per_call(&perf_counter_values::instructions),
+        c.per_call(&perf_counter_values::branch_misses),
+        c.per_call(&perf_counter_values::cache_misses),
+    };
+}
+
+/// Returns the hardware counters per input byte in the same order as counters_per_call,
+/// or std::nullopt when the benchmark does not declare its input size.
+std::optional<std::array<double, 4>> counters_per_byte(const bencode::benchmark::benchmark_counter_values& c)
+{
+    if (c.bytes_per_call == 0) return std::nullopt;
+    return std::array<double, 4> {
+        c.per_byte(&perf_counter_values::cycles),
+        c.per_byte(&perf_counter_values::instructions),
+        c.per_byte(&perf_counter_values::branch_misses),
+        c.per_byte(&perf_counter_values::cache_misses),
+    };
+}
+
+
+class csv_reporter : public record_reporter<csv_reporter>
+{
+public:
+    using record_reporter::record_reporter;
+
+    static std::string getDescription()
+    { return "Reports benchmark results as comma separated values"; }
+
+    void write(const std::vector<benchmark_record>& records)
+    {
+        stream << "test_case,section,benchmark,samples,iterations,"
+                  "mean_ns,mean_lower_bound_ns,mean_upper_bound_ns,standard_deviation_ns,outlier_variance,"
+                  "cycles,instructions,branch_misses,cache_misses,"
+                  "cycles_per_byte,instructions_per_byte,branch_misses_per_byte,cache_misses_per_byte\n";
+        for (const auto& r : records) {
+            stream << fmt::format("{},{},{},{},{},{},{},{},{},{},{}\n",
+                    quote(r.test_case), quote(r.section), quote(r.name),
+                    r.samples, r.iterations, r.mean, r.mean_lower_bound, r.mean_upper_bound,
+                    r.standard_deviation, r.outlier_variance, counters(r));
+        }
+    }
+
+private:
+    static std::string counters(const benchmark_record& r)
+    {
+        if (!r.counters) return ",,,,,,,";
+        const auto c = counters_per_call(*r.counters);
+        const auto b = counters_per_byte(*r.counters);
+        if (!b) return fmt::format("{},{},{},{},,,,", c[0], c[1], c[2], c[3]);
+        return fmt::format("{},{},{},{},{},{},{},{}",
+                           c[0], c[1], c[2], c[3], (*b)[0], (*b)[1], (*b)[2], (*b)[3]);
+    }
+
+    static std::string quote(std::string_view s)
+    {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        out += '"';
+        return out;
+    }
+};
+
+
+class json_reporter : public record_reporter<json_reporter>
+{
+public:
+    using record_reporter::record_reporter;
+
+    static std::string getDescription()
+    { return "Reports benchmark results as a json array"; }
+
+    void write(const std::vector<benchmark_record>& records)
+    {
+        stream << "[";
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto& r = records[i];
+            stream << (i == 0 ? "\n" : ",\n");
+            stream << fmt::format(
+                    "  {{\"test_case\": {}, \"section\": {}, \"benchmark\": {}, "
+                    "\"samples\": {}, \"iterations\": {}, \"mean_ns\": {}, "
+                    "\"mean_lower_bound_ns\": {}, \"mean_upper_bound_ns\": {}, "
+                    "\"standard_deviation_ns\": {}, \"outlier_variance\": {}, "
+                    "\"counters_per_call\": {}, \"counters_per_byte\": {}}}",
+                    quote(r.test_case), quote(r.section), quote(r.name),
+                    r.samples, r.iterations, r.mean, r.mean_lower_bound, r.mean_upper_bound,
+                    r.standard_deviation, r.outlier_variance, counters(r), byte_counters(r));
+        }
+        stream << "\n]\n";
+    }
+
+private:
+    static std::string counters(const benchmark_record& r)
+    {
+        if (!r.counters) return "null";
+        return counter_object(counters_per_call(*r.counters));
+    }
+
+    static std::string byte_counters(const benchmark_record& r)
+    {
+        if (!r.counters) return "null";
+        const auto b = counters_per_byte(*r.counters);
+        return b ? counter_object(*b) : "null";
+    }
+
+    static std::string counter_object(const std::array<double, 4>& c)
+    {
+        return fmt::format(R"({{"cycles": {}, "instructions": {}, "branch_misses": {}, "cache_misses": {}}})",
+                           c[0], c[1], c[2], c[3]);
+    }
+
+    static std::string quote(std::string_view s)
+    {
+        std::string out(bencode::detail::json_string_max_size(s.size()), '\0');
+        auto* last = bencode::detail::write_json_string(
+                out.data(), s, bencode::json_binary_encoding::escape);
+        out.resize(static_cast<std::size_t>(last - out.data()));
+        return out;
+    }
+};
+
+} // namespace
+
+CATCH_REGISTER_REPORTER("csv", csv_reporter)
+CATCH_REGISTER_REPORTER("json", json_reporter)
@@ -0,0 +1,206 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bencode/bencode.hpp"
+#include "bencode/traits/all.hpp"
+
+#include "data.hpp"
+#include "perf_counters.hpp"
+
+using namespace bencode::benchmark;
+
+TEST_CASE("benchmark bview accessors", "[bview]")
+{
+    const auto wide_data = make_wide_dict(1000);
+    auto wide = bencode::descriptor_parser<>(unlimited_options).parse(wide_data).value();
+    const auto wide_root = wide.get_root();
+    const auto& wide_dict = get_dict(wide_root);
+
+    const auto list_data = make_integer_list(1000);
+    auto integers = bencode::decode_view(list_data);
+    const auto integers_root = integers.get_root();
+    const auto& integer_list = get_list(integers_root);
+
+    auto torrent = bencode::decode_view(fedora_torrent());
+    const auto torrent_root = torrent.get_root();
+    const auto& torrent_dict = get_dict(torrent_root);
+
+    BENCODE_BENCHMARK("find - torrent") {
+        return torrent_dict.find("info");
+    };
+
+    BENCODE_BENCHMARK("find - first key of wide dict") {
+        return wide_dict.find("key000000");
+    };
+
+    BENCODE_BENCHMARK("find - last key of wide dict") {
+        return wide_dict.find("key000999");
+    };
+
+    BENCODE_BENCHMARK("find - missing key of wide dict") {
+        return wide_dict.find("missing");
+    };
+
+    BENCODE_BENCHMARK("find - last key of wide dict, key literal") {
+        using namespace bencode::literals;
+        return wide_dict.find("key000999"_key);
+    };
+
+    BENCODE_BENCHMARK("find - missing key of wide dict, key literal") {
+        using namespace bencode::literals;
+        return wide_dict.find("missing"_key);
+    };
+
+    const auto info = torrent_dict.at("info");
+    const auto& info_dict = get_dict(info);
+    const std::array<std::string_view, 6> info_keys {
+        "files", "length", "name", "piece length", "pieces", "private"};
+
+    BENCODE_BENCHMARK("find - 6 info fields") {
+        std::array<bencode::bview, 6> out {};
+        for (std::size_t i = 0; i < info_keys.size(); ++i) {
+            if (auto it = info_dict.find(info_keys[i]); it != info_dict.end())
+                out[i] = it->second;
+        }
+        return out;
+    };
+
+    BENCODE_BENCHMARK("find_many - 6 info fields") {
+        std::array<bencode::bview, 6> out {};
+        info_dict.find_many(info_keys, out);
+        return out;
+    };
+
+    const std::array<std::string_view, 8> wide_keys {
+        "key000100", "key000200", "key000300", "key000400",
+        "key000500", "key000600", "key000700", "key000800"};
+
+    BENCODE_BENCHMARK("find - 8 keys of wide dict") {
+        std::array<bencode::bview, 8> out {};
+        for (std::size_t i = 0; i < wide_keys.size(); ++i) {
+            if (auto it = wide_dict.find(wide_keys[i]); it != wide_dict.end())
+                out[i] = it->second;
+        }
+        return out;
+    };
+
+    BENCODE_BENCHMARK("find_many - 8 keys of wide dict") {
+        std::array<bencode::bview, 8> out {};
+        wide_dict.find_many(wide_keys, out);
+        return out;
+    };
+
+    BENCODE_BENCHMARK("list index") {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < integer_list.size(); i += 100)
+            sum += get_integer(integer_list[i]);
+        return sum;
+    };
+
+    BENCODE_BENCHMARK("list iteration") {
+        std::int64_t sum = 0;
+        for (const auto& v : integer_list)
+            sum += get_integer(v);
+        return sum;
+    };
+
+    BENCODE_BENCHMARK("dict iteration") {
+        std::size_t size = 0;
+        for (const auto& [k, v] : wide_dict)
+            size += k.size();
+        return size;
+    };
+}
+
+
+TEST_CASE("benchmark bview conversions", "[bview][conversion]")
+{
+    const auto list_data = make_integer_list(1000);
+    auto integers = bencode::decode_view(list_data);
+    const auto integers_root = integers.get_root();
+    const auto string_data = make_huge_string(1 << 16);
+    auto huge_string = bencode::decode_view(string_data);
+
+    BENCODE_BENCHMARK("get_as<std::int64_t>") {
+        std::int64_t sum = 0;
+        for (const auto& v : get_list(integers_root))
+            sum += bencode::get_as<std::int64_t>(v);
+        return sum;
+    };
+
+    BENCODE_BENCHMARK("get_as<std::uint8_t>") {
+        std::uint64_t sum = 0;
+        for (const auto& v : get_list(integers_root))
+            sum += bencode::get_as<std::uint8_t>(v);
+        return sum;
+    };
+
+    BENCODE_BENCHMARK("get_as<std::vector<int>>") {
+        return bencode::get_as<std::vector<int>>(integers_root);
+    };
+
+    BENCODE_BENCHMARK("get_as<std::string>") {
+        return bencode::get_as<std::string>(huge_string.get_root());
+    };
+}
+
+
+TEST_CASE("benchmark comparison", "[bview][comparison]")
+{
+    const auto& data = fedora_torrent();
+    const auto copy = std::string(data);
+    auto lhs = bencode::decode_view(data);
+    auto rhs = bencode::decode_view(copy);
+    const auto value = bencode::decode_value(data);
+
+    const auto list_data = make_integer_list(1000);
+    auto integers = bencode::decode_view(list_data);
+    const auto integers_root = integers.get_root();
+
+    const auto string_data = make_huge_string(1 << 20);
+    const auto string_copy = std::string(string_data);
+    auto huge_lhs = bencode::decode_view(string_data);
+    auto huge_rhs = bencode::decode_view(string_copy);
+
+    BENCODE_BENCHMARK("bview == bview - torrent") {
+        return lhs.get_root() == rhs.get_root();
+    };
+
+    BENCODE_BENCHMARK("bview == bview - info dict") {
+        return get_dict(lhs.get_root()).at("info") == get_dict(rhs.get_root()).at("info");
+    };
+
+    BENCODE_BENCHMARK("compute_subtree_hashes - torrent") {
+        lhs.compute_subtree_hashes();
+        return lhs.subtree_hashes().front();
+    };
+
+    BENCODE_BENCHMARK("bview <=> bview - torrent") {
+        return lhs.get_root() <=> rhs.get_root();
+    };
+
+    BENCODE_BENCHMARK("bvalue == bvalue - torrent") {
+        return value == value;
+    };
+
+    BENCODE_BENCHMARK("bview == bview - integer list") {
+        return integers_root == integers_root;
+    };
+
+    BENCODE_BENCHMARK("bview == integer") {
+        std::size_t n = 0;
+        for (const auto& v : get_list(integers_root))
+            n += (v == 42);
+        return n;
+    };
+
+    BENCODE_BENCHMARK("bview == bview - huge string") {
+        return huge_lhs.get_root() == huge_rhs.get_root();
+    };
+}
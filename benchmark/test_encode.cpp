@@ -0,0 +1,195 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "bencode/bencode.hpp"
+#include "bencode/lazy_bvalue.hpp"
+#include "bencode/diff.hpp"
+#include "bencode/merge.hpp"
+#include "bencode/traits/all.hpp"
+
+#include "data.hpp"
+#include "perf_counters.hpp"
+
+using namespace bencode::benchmark;
+
+static void benchmark_encode(const std::string& data)
+{
+    const auto value = bencode::decode_value(data);
+    auto view = bencode::decode_view(data);
+
+    BENCODE_BENCHMARK("encode bvalue") {
+        return bencode::encode(value);
+    };
+
+    BENCODE_BENCHMARK("encode bview") {
+        return bencode::encode(view.get_root());
+    };
+
+    BENCODE_BENCHMARK("encode_to back_inserter") {
+        std::string out {};
+        out.reserve(data.size());
+        bencode::encode_to(std::back_inserter(out), value);
+        return out;
+    };
+
+    BENCODE_BENCHMARK("encode_to ostream") {
+        std::ostringstream os {};
+        bencode::encode_to(os, value);
+        return os.str();
+    };
+}
+
+
+TEST_CASE("benchmark encode", "[encode]")
+{
+    SECTION("fedora workstation") {
+        benchmark_encode(fedora_torrent());
+    }
+
+    SECTION("DHT message") {
+        benchmark_encode(make_dht_message());
+    }
+}
+
+
+TEST_CASE("benchmark edit and re-encode", "[encode]")
+{
+    const auto& data = fedora_torrent();
+
+    BENCODE_BENCHMARK("decode_value") {
+        auto value = bencode::decode_value(data);
+        value["info"]["name"] = "renamed";
+        return bencode::encode(value);
+    };
+
+    BENCODE_BENCHMARK("lazy_bvalue") {
+        auto view = bencode::decode_view(data);
+        auto value = bencode::lazy_bvalue(view.get_root());
+        value["info"]["name"] = "renamed";
+        return bencode::encode(value);
+    };
+}
+
+
+TEST_CASE("benchmark encode unordered_map", "[encode]")
+{
+    // a scrape response with one entry per info hash
+    for (std::size_t n : {100, 50000}) {
+        std::unordered_map<std::string, std::int64_t> files {};
+        for (std::size_t i = 0; i < n; ++i) {
+            files.emplace(fmt::format("{:020x}", i * 0x9e3779b97f4a7c15ull), i);
+        }
+
+        BENCODE_BENCHMARK(fmt::format("{} entries", n)) {
+            return bencode::encode(files);
+        };
+    }
+}
+
+
+TEST_CASE("benchmark hash", "[encode][hash]")
+{
+    const auto& data = fedora_torrent();
+    const auto value = bencode::decode_value(data);
+    auto view = bencode::decode_view(data);
+
+    BENCODE_BENCHMARK("hash bvalue") {
+        return bencode::hash(value);
+    };
+
+    BENCODE_BENCHMARK("hash bview") {
+        return bencode::hash(view.get_root());
+    };
+
+    BENCODE_BENCHMARK("encode bvalue + std::hash<std::string>") {
+        return std::hash<std::string>{}(bencode::encode(value));
+    };
+}
+
+TEST_CASE("benchmark diff and patch", "[encode][diff]")
+{
+    const auto& data = fedora_torrent();
+    auto modified_value = bencode::decode_value(data);
+    modified_value["info"]["name"] = "renamed";
+    modified_value["comment"] = "synced";
+    const auto modified = bencode::encode(modified_value);
+
+    auto a = bencode::decode_view(data);
+    auto b = bencode::decode_view(modified);
+    const auto p = bencode::diff(a.get_root(), b.get_root());
+
+    BENCODE_BENCHMARK("diff") {
+        return bencode::diff(a.get_root(), b.get_root());
+    };
+
+    BENCODE_BENCHMARK("apply_patch") {
+        return bencode::apply_patch(a.get_root(), p);
+    };
+
+    BENCODE_BENCHMARK("encode_patch") {
+        return bencode::encode_patch(p);
+    };
+}
+
+TEST_CASE("benchmark merge", "[encode][merge]")
+{
+    const auto& data = fedora_torrent();
+    const std::string overlay = "d7:comment6:tenant4:infod4:name7:renamedee";
+
+    BENCODE_BENCHMARK("decode_value and merge") {
+        auto value = bencode::decode_value(data);
+        auto override = bencode::decode_value(overlay);
+        auto& info = get_dict(value["info"]);
+        for (auto& [k, v] : get_dict(override["info"]))
+            info.insert_or_assign(k, std::move(v));
+        value["comment"] = std::move(override["comment"]);
+        return bencode::encode(value);
+    };
+
+    BENCODE_BENCHMARK("merge") {
+        auto base = bencode::decode_view(data);
+        auto override = bencode::decode_view(overlay);
+        return bencode::merge(get_dict(base.get_root()), get_dict(override.get_root()));
+    };
+}
+
+TEST_CASE("benchmark encoder", "[encode]")
+{
+    BENCODE_BENCHMARK("integer list") {
+        std::string out {};
+        auto enc = bencode::encoder(std::back_inserter(out));
+        enc << bencode::begin_list;
+        for (std::int64_t i = 0; i < 1000; ++i) enc << i;
+        enc << bencode::end_list;
+        return out;
+    };
+
+    const std::string id_data(20, 'i');
+    const std::string nodes_data(208, 'n');
+    const std::string_view id = id_data;
+    const std::string_view nodes = nodes_data;
+
+    BENCODE_BENCHMARK("DHT message") {
+        std::string out {};
+        auto enc = bencode::encoder(std::back_inserter(out));
+        enc << bencode::begin_dict
+                << "r" << bencode::begin_dict
+                    << "id" << id
+                    << "nodes" << nodes
+                    << "token" << "aoeusnth"
+                    << "values" << bencode::begin_list;
+        for (int i = 0; i < 8; ++i) enc << "axje.u";
+        enc         << bencode::end_list
+                << bencode::end_dict
+                << "t" << "aa"
+                << "y" << "r"
+            << bencode::end_dict;
+        return out;
+    };
+}
@@ -0,0 +1,59 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/bencode.hpp"
+#include "bencode/events/encode_json_to.hpp"
+#include "bencode/events/format_json_to.hpp"
+
+#include "data.hpp"
+#include "perf_counters.hpp"
+
+using namespace bencode::benchmark;
+
+static void benchmark_json(const std::string& data)
+{
+    const auto value = bencode::decode_value(data);
+    auto view = bencode::decode_view(data);
+
+    BENCODE_BENCHMARK("format_json_to - bvalue") {
+        std::string out {};
+        auto consumer = bencode::events::format_json_to(std::back_inserter(out));
+        connect(consumer, value);
+        return out;
+    };
+
+    BENCODE_BENCHMARK("format_json_to - bview") {
+        std::string out {};
+        auto consumer = bencode::events::format_json_to(std::back_inserter(out));
+        connect(consumer, view.get_root());
+        return out;
+    };
+
+    BENCODE_BENCHMARK("encode_json_to - bview") {
+        std::string out {};
+        auto consumer = bencode::events::encode_json_to(out);
+        connect(consumer, view.get_root());
+        return out;
+    };
+
+    BENCODE_BENCHMARK("encode_json_to - bview, hex") {
+        std::string out {};
+        auto consumer = bencode::events::encode_json_to(out, bencode::json_binary_encoding::hex);
+        connect(consumer, view.get_root());
+        return out;
+    };
+}
+
+
+TEST_CASE("benchmark json", "[json]")
+{
+    SECTION("fedora workstation") {
+        benchmark_json(fedora_torrent());
+    }
+
+    SECTION("DHT message") {
+        benchmark_json(make_dht_message());
+    }
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "bencode/bencode.hpp"
+
+#include "allocation_counter.hpp"
+#include "data.hpp"
+
+using namespace bencode::benchmark;
+
+// Memory mode: run with `bencode-benchmark [memory]`.
+// Prints one CSV row per document and decoder to stdout with the allocations made while
+// decoding and the memory retained by the decoded result.
+
+static void report_memory_usage(std::string_view document, std::string_view data)
+{
+    start_counting_allocations();
+    auto value = bencode::decode_value(data);
+    const auto value_allocations = stop_counting_allocations();
+    const auto value_usage = value.memory_usage();
+
+    // keys seen before are not allocated again, the first decode fills the global key pool
+    (void) bencode::decode_value<bencode::interning_bvalue_policy>(data);
+    start_counting_allocations();
+    auto interned = bencode::decode_value<bencode::interning_bvalue_policy>(data);
+    const auto interned_allocations = stop_counting_allocations();
+    const auto interned_usage = interned.memory_usage();
+
+    start_counting_allocations();
+    auto small = bencode::decode_value<bencode::small_string_bvalue_policy>(data);
+    const auto small_allocations = stop_counting_allocations();
+    const auto small_usage = small.memory_usage();
+
+    start_counting_allocations();
+    auto borrowed = bencode::decode_value<bencode::borrowed_bvalue_policy>(data);
+    const auto borrowed_allocations = stop_counting_allocations();
+    const auto borrowed_usage = borrowed.memory_usage();
+
+    start_counting_allocations();
+    auto view = bencode::decode_view(data);
+    const auto view_allocations = stop_counting_allocations();
+    const auto view_usage = view.memory_usage();
+
+    CHECK(value_usage.node_count == view_usage.node_count);
+
+    constexpr auto row = "\"{}\",{},{},{},{},{},{},{}\n";
+    fmt::print(row, document, "decode_value", data.size(),
+               value_allocations.allocations, value_allocations.bytes,
+               value_usage.allocation_count, value_usage.total_bytes, value_usage.node_count);
+    fmt::print(row, document, "decode_value interned keys", data.size(),
+               interned_allocations.allocations, interned_allocations.bytes,
+               interned_usage.allocation_count, interned_usage.total_bytes, interned_usage.node_count);
+    fmt::print(row, document, "decode_value small strings", data.size(),
+               small_allocations.allocations, small_allocations.bytes,
+               small_usage.allocation_count, small_usage.total_bytes, small_usage.node_count);
+    fmt::print(row, document, "decode_value borrowed strings", data.size(),
+               borrowed_allocations.allocations, borrowed_allocations.bytes,
+               borrowed_usage.allocation_count, borrowed_usage.total_bytes, borrowed_usage.node_count);
+    fmt::print(row, document, "decode_view", data.size(),
+               view_allocations.allocations, view_allocations.bytes,
+               view_usage.allocation_count, view_usage.total_bytes, view_usage.node_count);
+}
+
+
+TEST_CASE("memory usage of decoded documents", "[.][memory]")
+{
+    fmt::print("document,decoder,input_bytes,allocations,allocated_bytes,"
+               "retained_allocations,retained_bytes,nodes\n");
+    report_memory_usage("fedora workstation", fedora_torrent());
+    report_memory_usage("NASA mdim_color", nasa_torrent());
+    report_memory_usage("COVID-19 image dataset", covid_torrent());
+    report_memory_usage("DHT message", make_dht_message());
+    report_memory_usage("many small integers", make_integer_list(4000));
+}
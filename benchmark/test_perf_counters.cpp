@@ -0,0 +1,86 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "bencode/bencode.hpp"
+#include "bencode/parsers/reader.hpp"
+
+#include "data.hpp"
+#include "perf_counters.hpp"
+
+using namespace bencode::benchmark;
+
+// Hardware counter mode: run with `bencode-benchmark [perf]`.
+// Prints one CSV row per document and parser to stdout with cycles, instructions,
+// branch misses and cache misses per input byte, averaged over a number of runs.
+// The csv and json reporters record the same counters per call for every BENCODE_BENCHMARK
+// and per input byte for every BENCODE_BENCHMARK_BYTES.
+
+namespace {
+
+constexpr std::size_t runs = 50;
+
+template <typename F>
+void report_counters(perf_counters& counters, std::string_view document, std::string_view parser,
+                     std::string_view data, F&& f)
+{
+    // results are passed to a sink so the measured work is not optimized away
+    Catch::Benchmark::deoptimize_value(f()); // warm up
+
+    counters.start();
+    for (std::size_t i = 0; i < runs; ++i) Catch::Benchmark::deoptimize_value(f());
+    const auto c = counters.stop();
+
+    const double bytes = static_cast<double>(data.size() * runs);
+    fmt::print("\"{}\",{},{},{:.4f},{:.4f},{:.6f},{:.6f},{:.4f}\n",
+            document, parser, data.size(),
+            c.cycles / bytes, c.instructions / bytes,
+            c.branch_misses / bytes, c.cache_misses / bytes,
+            c.cycles == 0 ? 0.0 : static_cast<double>(c.instructions) / c.cycles);
+}
+
+void report_document(perf_counters& counters, std::string_view document, std::string_view data)
+{
+    report_counters(counters, document, "push_parser", data, [&] {
+        auto consumer = bencode::events::to_bvalue<bencode::default_bvalue_policy>{};
+        auto parser = bencode::push_parser(unlimited_options);
+        parser.parse(consumer, data);
+        return consumer.value();
+    });
+    report_counters(counters, document, "descriptor_parser", data, [&] {
+        auto parser = bencode::descriptor_parser(unlimited_options);
+        return parser.parse(data);
+    });
+    report_counters(counters, document, "reader skip_value", data, [&] {
+        auto r = bencode::reader(data, unlimited_options);
+        r.skip_value();
+        return r.position();
+    });
+}
+
+} // namespace
+
+
+TEST_CASE("hardware counters per input byte", "[.][perf]")
+{
+    perf_counters counters {};
+    if (!counters.available()) {
+        WARN("hardware counters unavailable: " << counters.unavailable_reason());
+        return;
+    }
+
+    fmt::print("document,parser,input_bytes,cycles_per_byte,instructions_per_byte,"
+               "branch_misses_per_byte,cache_misses_per_byte,instructions_per_cycle\n");
+    report_document(counters, "fedora workstation", fedora_torrent());
+    report_document(counters, "NASA mdim_color", nasa_torrent());
+    report_document(counters, "COVID-19 image dataset", covid_torrent());
+    report_document(counters, "deep nesting", make_deep_nesting(2000));
+    report_document(counters, "wide dict", make_wide_dict(10000));
+    report_document(counters, "huge string", make_huge_string(1 << 24));
+    report_document(counters, "many small integers", make_integer_list(100000));
+    report_document(counters, "DHT message", make_dht_message());
+}
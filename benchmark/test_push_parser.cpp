@@ -9,6 +9,8 @@
 //#include "bencode/detail/parser/simd/simd_parser.hpp"
 #include "bencode/detail/parser/descriptor_parser.hpp"
 
+#include "perf_counters.hpp"
+
 
 #include <ranges>
 #include <string_view>
@@ -28,12 +30,27 @@ void benchmark_helper(std::istream& ifs)
             std::istreambuf_iterator<char>{ifs},
             std::istreambuf_iterator<char>{});
 
-    BENCHMARK("decode_value") {
+    BENCODE_BENCHMARK_BYTES("decode_value", torrent.size()) {
         auto d = bencode::decode_value(torrent);
         return d;
     };
 
-    BENCHMARK("decode_view") {
+    BENCODE_BENCHMARK_BYTES("decode_value - interned keys", torrent.size()) {
+        auto d = bencode::decode_value<bencode::interning_bvalue_policy>(torrent);
+        return d;
+    };
+
+    BENCODE_BENCHMARK_BYTES("decode_value - small strings", torrent.size()) {
+        auto d = bencode::decode_value<bencode::small_string_bvalue_policy>(torrent);
+        return d;
+    };
+
+    BENCODE_BENCHMARK_BYTES("decode_value - borrowed strings", torrent.size()) {
+        auto d = bencode::decode_value<bencode::borrowed_bvalue_policy>(torrent);
+        return d;
+    };
+
+    BENCODE_BENCHMARK_BYTES("decode_view", torrent.size()) {
          auto d = bencode::decode_view(torrent);
          return d;
      };
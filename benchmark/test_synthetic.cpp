@@ -0,0 +1,58 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include "bencode/bencode.hpp"
+#include "bencode/parsers/reader.hpp"
+
+#include "data.hpp"
+#include "perf_counters.hpp"
+
+using namespace bencode::benchmark;
+
+static void benchmark_shape(std::string_view data)
+{
+    BENCODE_BENCHMARK_BYTES("push_parser", data.size()) {
+        auto consumer = bencode::events::to_bvalue<bencode::default_bvalue_policy>{};
+        auto parser = bencode::push_parser(unlimited_options);
+        parser.parse(consumer, data);
+        return consumer.value();
+    };
+
+    BENCODE_BENCHMARK_BYTES("descriptor_parser", data.size()) {
+        auto parser = bencode::descriptor_parser(unlimited_options);
+        return parser.parse(data);
+    };
+
+    BENCODE_BENCHMARK_BYTES("reader skip_value", data.size()) {
+        auto r = bencode::reader(data, unlimited_options);
+        r.skip_value();
+        return r.position();
+    };
+}
+
+
+TEST_CASE("benchmark synthetic shapes", "[parser][synthetic]")
+{
+    SECTION("deep nesting") {
+        benchmark_shape(make_deep_nesting(2000));
+    }
+
+    SECTION("wide dict") {
+        benchmark_shape(make_wide_dict(10000));
+    }
+
+    SECTION("huge string") {
+        benchmark_shape(make_huge_string(1 << 24));
+    }
+
+    SECTION("many small integers") {
+        benchmark_shape(make_integer_list(100000));
+    }
+
+    SECTION("DHT message") {
+        benchmark_shape(make_dht_message());
+    }
+}
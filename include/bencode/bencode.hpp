@@ -1,6 +1,6 @@
 #pragma once
 
-#include "bvalue.hpp"
 #include "bview.hpp"
+#include "bvalue.hpp"
 #include "encode.hpp"
-
+#include "hash.hpp"
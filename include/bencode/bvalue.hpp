@@ -3,6 +3,9 @@
 #include "bencode/traits/fundamentals.hpp"
 
 #include "bencode/detail/bvalue/basic_bvalue.hpp"
+#include "bencode/detail/bvalue/counting_allocator.hpp"
+#include "bencode/detail/bvalue/interned_string.hpp"
+#include "bencode/detail/bvalue/small_string.hpp"
 #include "bencode/detail/bvalue/concepts.hpp"
 #include "bencode/detail/bvalue/accessors.hpp"
 #include "bencode/detail/bvalue/assignment.hpp"
@@ -0,0 +1,3 @@
+#pragma once
+
+#include "bencode/detail/decode_batch.hpp"
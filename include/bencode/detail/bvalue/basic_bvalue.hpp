@@ -3,8 +3,12 @@
 #include <compare>
 #include <iosfwd>
 #include <limits>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 
 #include <fmt/format.h>
@@ -16,6 +20,8 @@
 #include <bencode/detail/conversion_error.hpp>
 
 #include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/key_literal.hpp"
+#include "bencode/detail/memory_usage.hpp"
 #include "bencode/detail/bvalue/bvalue_policy.hpp"
 #include "bencode/detail/bvalue/accessors.hpp"
 #include "bencode/detail/bvalue/assignment.hpp"
@@ -94,9 +100,23 @@ public:
     using string_value_type = typename string_type::value_type;
 
     constexpr basic_bvalue() noexcept = default;
-    constexpr basic_bvalue(const basic_bvalue& other) noexcept(std::is_nothrow_copy_constructible_v<storage_type>) = default;
+    /// Copy constructor. Nested lists and dicts are copied with an explicit stack,
+    /// so the call stack does not grow with the nesting depth of other.
+    basic_bvalue(const basic_bvalue& other)
+    {
+        if (other.is_structured()) clone_nested(other);
+        else storage_ = other.storage_;
+    }
+
     constexpr basic_bvalue(basic_bvalue&& other) noexcept(std::is_nothrow_move_constructible_v<storage_type>) = default;
 
+    /// Destructor. Nested lists and dicts are released with an explicit stack,
+    /// so the call stack does not grow with the nesting depth of the value.
+    ~basic_bvalue()
+    {
+        if (is_structured()) release_nested();
+    }
+
     basic_bvalue(dict_init_list il)
         : basic_bvalue(dict_type{})
     {
@@ -184,7 +204,12 @@ public:
 public:
     // TODO: add converting assignment operator instead of current implicit construction + move
 
-    constexpr basic_bvalue& operator=(const basic_bvalue& rhs) = default;
+    basic_bvalue& operator=(const basic_bvalue& rhs)
+    {
+        if (this != &rhs) *this = basic_bvalue(rhs);
+        return *this;
+    }
+
     constexpr basic_bvalue& operator=(basic_bvalue&& rhs) noexcept(std::is_nothrow_move_assignable_v<storage_type>) = default;
 
     template <typename T>
@@ -405,6 +430,28 @@ public:
         return std::get_if<dict_type>(&storage_)->at(key);
     }
 
+    /// @copydoc at(const string_type&)
+    reference at(const key_literal& key)
+    {
+        if (!is_dict()) [[unlikely]]
+            throw bad_bvalue_access("bvalue alternative type is not dict");
+        auto& d = *std::get_if<dict_type>(&storage_);
+        if (auto it = find_key(d, key); it != d.end())
+            return it->second;
+        throw std::out_of_range("no item with given key found");
+    }
+
+    /// @copydoc at(const string_type&)
+    const_reference at(const key_literal& key) const
+    {
+        if (!is_dict()) [[unlikely]]
+            throw bad_bvalue_access("bvalue alternative type is not dict");
+        const auto& d = *std::get_if<dict_type>(&storage_);
+        if (auto it = find_key(d, key); it != d.end())
+            return it->second;
+        throw std::out_of_range("no item with given key found");
+    }
+
     /// Returns a reference to the element at specified location pos.
     /// No bounds checking is performed.
     /// If the active alternative is not a list an exception of type bencode::bad_bvalue_access is thrown.
@@ -450,6 +497,18 @@ public:
         return (*std::get_if<dict_type>(&storage_))[std::move(key)];
     }
 
+    /// @copydoc operator[](const string_type&)
+    reference operator[](const key_literal& key)
+    {
+        if (is_uninitialized()) emplace_dict();
+        else if (!is_dict())
+            throw bad_bvalue_access("bvalue alternative type is not dict");
+        auto& d = *std::get_if<dict_type>(&storage_);
+        if (auto it = find_key(d, key); it != d.end())
+            return it->second;
+        return d[dict_key_type(key.view())];
+    }
+
     /// Returns a reference to the first element in the container.
     /// Calling front on an empty container is undefined
     /// @returns reference to the first element
@@ -561,6 +620,15 @@ public:
         return bdict.find(key) != end(bdict);
     }
 
+    /// @copydoc contains(const dict_key_type&) const
+    bool contains(const key_literal& key) const
+    {
+        if (!is_dict())
+            throw bad_bvalue_access("bvalue alternative type is not dict");
+        const auto& bdict = *std::get_if<dict_type>(&storage_);
+        return find_key(bdict, key) != end(bdict);
+    }
+
     /// Remove all elements from the current alternative.
     /// If the current alternative is a dict, list, string, calls clear on the underlying container.
     /// If the current alternative is an integer, set the bvalue to zero.
@@ -578,6 +646,144 @@ public:
         }, storage_);
     }
 
+    /// Returns the memory used by this value and all nested values.
+    /// Heap usage of the storage containers is derived from their size and capacity,
+    /// the exact number of allocations can be measured with counting_bvalue_policy.
+    memory_footprint memory_usage() const
+    {
+        memory_footprint m { .total_bytes = sizeof(basic_bvalue) };
+        std::vector<const basic_bvalue*> stack { this };
+
+        while (!stack.empty()) {
+            const basic_bvalue* current = stack.back();
+            stack.pop_back();
+
+            std::visit([&](const auto& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, uninitialized_type>) {
+                    return;
+                }
+                else if constexpr (std::is_same_v<T, integer_type>) {
+                    ++m.integer_count;
+                }
+                else if constexpr (std::is_same_v<T, string_type>) {
+                    ++m.string_count;
+                    detail::add_string_heap_usage(m, arg);
+                }
+                else if constexpr (std::is_same_v<T, list_type>) {
+                    ++m.list_count;
+                    detail::add_list_heap_usage(m, arg);
+                    for (const auto& v : arg) stack.push_back(&v);
+                }
+                else if constexpr (std::is_same_v<T, dict_type>) {
+                    ++m.dict_count;
+                    detail::add_dict_heap_usage(m, arg);
+                    for (const auto& [k, v] : arg) {
+                        detail::add_string_heap_usage(m, k);
+                        stack.push_back(&v);
+                    }
+                }
+            }, current->storage_);
+        }
+
+        m.node_count = m.integer_count + m.string_count + m.list_count + m.dict_count;
+        m.total_bytes += m.heap_bytes;
+        return m;
+    }
+
+private:
+    /// Find a key_literal in a dict, without allocating a key when the comparison is transparent.
+    template <typename Dict>
+    static auto find_key(Dict& d, const key_literal& key)
+    {
+        if constexpr (requires { typename detail::policy_dict_key_compare<Policy>::is_transparent; })
+            return d.find(key.view());
+        else
+            return d.find(dict_key_type(key.view()));
+    }
+
+    /// Copy the nested lists and dicts of other into this value.
+    /// Each pass copies the primitive elements of one container and leaves placeholders
+    /// for nested containers, which are filled from a stack of pending copies.
+    void clone_nested(const basic_bvalue& other)
+    {
+        std::vector<std::pair<const basic_bvalue*, basic_bvalue*>> stack { {&other, this} };
+
+        while (!stack.empty()) {
+            const auto [src, dst] = stack.back();
+            stack.pop_back();
+
+            if (const auto* l = std::get_if<list_type>(&src->storage_)) {
+                auto& out = dst->storage_.template emplace<list_type>();
+                if constexpr (requires { out.reserve(l->size()); }) {
+                    out.reserve(l->size());
+                }
+                for (const auto& v : *l) {
+                    if (v.is_structured()) out.emplace_back();
+                    else out.push_back(v);
+                }
+                // elements are no longer moved after the list is filled
+                auto it = out.begin();
+                for (const auto& v : *l) {
+                    if (v.is_structured()) stack.emplace_back(&v, std::addressof(*it));
+                    ++it;
+                }
+            }
+            else if (const auto* d = std::get_if<dict_type>(&src->storage_)) {
+                auto& out = dst->storage_.template emplace<dict_type>();
+                for (const auto& [k, v] : *d) {
+                    if (v.is_structured()) {
+                        auto it = out.emplace_hint(out.end(), k, basic_bvalue{});
+                        stack.emplace_back(&v, std::addressof(it->second));
+                    }
+                    else {
+                        out.emplace_hint(out.end(), k, v);
+                    }
+                }
+            }
+            else {
+                dst->storage_ = src->storage_;
+            }
+        }
+    }
+
+    /// Move nested non-empty lists and dicts out of this value onto a stack
+    /// and release them one level at a time.
+    /// When the stack cannot grow, the remaining values are left in place and released
+    /// recursively by their parent.
+    void release_nested() noexcept
+    {
+        std::vector<basic_bvalue> stack {};
+
+        auto take_nested = [&](basic_bvalue& value) {
+            auto take = [&](basic_bvalue& v) {
+                const auto* l = std::get_if<list_type>(&v.storage_);
+                const auto* d = std::get_if<dict_type>(&v.storage_);
+                if ((l && !l->empty()) || (d && !d->empty())) {
+                    try {
+                        stack.push_back(std::move(v));
+                    }
+                    catch (const std::bad_alloc&) {
+                        // push_back leaves v unchanged when reallocation fails
+                    }
+                }
+            };
+            if (auto* l = std::get_if<list_type>(&value.storage_)) {
+                for (auto& v : *l) take(v);
+            }
+            else if (auto* d = std::get_if<dict_type>(&value.storage_)) {
+                for (auto& [k, v] : *d) take(v);
+            }
+        };
+
+        take_nested(*this);
+        while (!stack.empty()) {
+            basic_bvalue current = std::move(stack.back());
+            stack.pop_back();
+            take_nested(current);
+        }
+    }
+
 public:
     void swap(basic_bvalue& other)
     noexcept(noexcept(std::declval<storage_type>().swap(std::declval<storage_type>())))
@@ -6,6 +6,7 @@
 #include <variant>
 #include <map>
 #include <concepts>
+#include <ranges>
 
 
 
@@ -99,6 +100,11 @@ using policy_list_init_list_t = std::initializer_list<basic_bvalue<Policy>>;
 template <typename Policy>
 using policy_dict_key_compare = typename Policy::template storage<basic_bvalue<Policy>>::dict_type::key_compare;
 
+/// A policy is borrowing when its string type does not own its characters, e.g. std::string_view.
+/// Values of such a policy refer to the buffer they were decoded from.
+template <typename Policy>
+concept borrowing_policy = std::ranges::borrowed_range<policy_string_t<Policy>>;
+
 
 // TODO: test custom policy support
 
@@ -145,6 +151,18 @@ struct default_bvalue_policy
             detail::default_policy_helper::template dict_type
         > {};
 
+/// Policy storing strings and dict keys as std::string_view into the buffer a value was
+/// decoded from. Lists and dicts are owned and mutable, no string bytes are copied.
+/// The buffer must outlive the value, as for bview.
+struct borrowed_bvalue_policy
+        : bvalue_policy<
+            std::int64_t,
+            std::string_view,
+            std::string_view,
+            detail::default_policy_helper::template list_type,
+            detail::default_policy_helper::template dict_type
+        > {};
+
 //// use transparent comparator
 //struct transparent_comparator_policy : policy<
 //        std::int64_t,
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bencode/detail/bvalue/bvalue_policy.hpp"
+
+namespace bencode {
+
+/// Allocation counters of a thread, updated by counting_allocator.
+struct allocation_stats
+{
+    std::size_t allocation_count = 0;
+    std::size_t deallocation_count = 0;
+    std::size_t allocated_bytes = 0;
+    std::size_t deallocated_bytes = 0;
+    /// Largest value of bytes_in_use() since the last reset.
+    std::size_t peak_bytes = 0;
+
+    constexpr std::size_t bytes_in_use() const noexcept
+    { return allocated_bytes - deallocated_bytes; }
+};
+
+/// Returns the allocation counters of the calling thread.
+/// Assign a default constructed allocation_stats to reset the counters.
+inline allocation_stats& thread_allocation_stats() noexcept
+{
+    thread_local allocation_stats stats {};
+    return stats;
+}
+
+/// Stateless allocator that forwards to std::allocator and records every
+/// allocation and deallocation in the allocation_stats of the calling thread.
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    constexpr counting_allocator() noexcept = default;
+
+    template <typename U>
+    constexpr counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        auto* p = std::allocator<T>{}.allocate(n);
+        auto& stats = thread_allocation_stats();
+        ++stats.allocation_count;
+        stats.allocated_bytes += n * sizeof(T);
+        if (stats.bytes_in_use() > stats.peak_bytes)
+            stats.peak_bytes = stats.bytes_in_use();
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        auto& stats = thread_allocation_stats();
+        ++stats.deallocation_count;
+        stats.deallocated_bytes += n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    constexpr bool operator==(const counting_allocator<U>&) const noexcept
+    { return true; }
+};
+
+namespace detail {
+
+struct counting_policy_helper
+{
+    using string_type = std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+    template<typename V>
+    using list_type = std::vector<V, counting_allocator<V>>;
+
+    template<typename K, typename V>
+    using dict_type = std::map<K, V, std::less<>, counting_allocator<std::pair<const K, V>>>;
+};
+
+} // namespace detail
+
+/// Policy using counting_allocator for all storage containers.
+/// Decoding to basic_bvalue<counting_bvalue_policy> gives the exact number and size
+/// of the allocations of a decoded document in thread_allocation_stats().
+struct counting_bvalue_policy
+        : bvalue_policy<
+            std::int64_t,
+            std::string_view,
+            detail::counting_policy_helper::string_type,
+            detail::counting_policy_helper::template list_type,
+            detail::counting_policy_helper::template dict_type
+        > {};
+
+} // namespace bencode
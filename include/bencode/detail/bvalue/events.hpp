@@ -1,15 +1,42 @@
 #pragma once
 
-#include <stack>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <optional>
 
 #include <bencode/detail/bvalue/basic_bvalue.hpp>
 #include <bencode/detail/events/concepts.hpp>
+#include <bencode/detail/events/traversal.hpp>
 
 namespace bencode::detail {
 
+/// Traversal traits for basic_bvalue, nodes are pointers to values.
+template <typename Policy>
+struct bvalue_traversal_traits
+{
+    using value_type = basic_bvalue<Policy>;
+    using node = const value_type*;
+    using list_iterator = typename policy_list_t<Policy>::const_iterator;
+    using dict_iterator = typename policy_dict_t<Policy>::const_iterator;
+    static constexpr bool sized_end = false;
+
+    static constexpr bencode_type type(node n) noexcept { return n->type(); }
+    static constexpr decltype(auto) integer(node n) { return get_integer(*n); }
+    static constexpr decltype(auto) string(node n) { return get_string(*n); }
+    static constexpr std::size_t size(node n)
+    { return n->type() == bencode_type::list ? get_list(*n).size() : get_dict(*n).size(); }
+
+    static constexpr list_iterator list_begin(node n) { return get_list(*n).begin(); }
+    static constexpr list_iterator list_end(node n) { return get_list(*n).end(); }
+    static constexpr dict_iterator dict_begin(node n) { return get_dict(*n).begin(); }
+    static constexpr dict_iterator dict_end(node n) { return get_dict(*n).end(); }
+
+    static constexpr node list_item(const list_iterator& it) { return std::addressof(*it); }
+    static constexpr decltype(auto) dict_key(const dict_iterator& it) { return (it->first); }
+    static constexpr node dict_value(const dict_iterator& it) { return std::addressof(it->second); }
+};
+
 template <typename Policy, typename U, event_consumer EC>
 constexpr void connect_events_default_runtime_impl(
         customization_point_type<basic_bvalue<Policy>>,
@@ -17,42 +44,7 @@ constexpr void connect_events_default_runtime_impl(
         U&& value,
         priority_tag<1>)
 {
-    using vt = bencode::bencode_type;
-    switch (value.type()) {
-        case vt::uninitialized: break;
-        case vt::integer: {
-            consumer.integer(get_integer(value));
-            break;
-        }
-        case vt::string: {
-            consumer.string(get_string(value));
-            break;
-        }
-        case vt::list: {
-            const auto& list = get_list(value);
-            std::size_t size = list.size();
-            consumer.begin_list(size);
-            for (const auto& v : get_list(value)) {
-                connect(consumer, v);
-                consumer.list_item();
-            }
-            consumer.end_list();
-            break;
-        }
-        case vt::dict: {
-            const auto& dict = get_dict(value);
-            std::size_t size = dict.size();
-            consumer.begin_dict(size);
-            for (const auto&[k, v] : dict) {
-                consumer.string(k);
-                consumer.dict_key();
-                connect(consumer, v);
-                consumer.dict_value();
-            }
-            consumer.end_dict();
-            break;
-        }
-    }
+    connect_iterative<bvalue_traversal_traits<Policy>>(consumer, std::addressof(value));
 }
 
 } // bencode::detail
\ No newline at end of file
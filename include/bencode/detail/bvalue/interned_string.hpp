@@ -0,0 +1,297 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "bencode/detail/bvalue/bvalue_policy.hpp"
+
+namespace bencode {
+
+/// Thread-safe pool of unique strings.
+///
+/// Every distinct string is stored once and kept until the pool is cleared or destroyed,
+/// so references returned by intern() remain valid until then.
+/// The pool is split in shards with a mutex each, so threads interning different
+/// strings rarely wait for each other.
+///
+/// The global pool grows with every distinct key for the lifetime of the process.
+/// To bound its memory use, intern the keys of a group of values in a pool owned by the caller,
+/// see key_pool::scope, and destroy it together with the values.
+class key_pool
+{
+public:
+    class scope;
+
+    key_pool() = default;
+
+    key_pool(const key_pool&) = delete;
+    key_pool& operator=(const key_pool&) = delete;
+
+    /// Returns the pooled copy of s, adding it to the pool if not yet present.
+    const std::string& intern(std::string_view s)
+    {
+        auto& shard = shards_[string_hash{}(s) % shard_count];
+        std::scoped_lock lock(shard.mutex);
+        if (auto it = shard.strings.find(s); it != shard.strings.end())
+            return *it;
+        return *shard.strings.emplace(s).first;
+    }
+
+    /// Returns the number of unique strings in the pool.
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const auto& shard : shards_) {
+            std::scoped_lock lock(shard.mutex);
+            n += shard.strings.size();
+        }
+        return n;
+    }
+
+    /// Returns the number of bytes of string data stored in the pool.
+    std::size_t string_bytes() const
+    {
+        std::size_t n = 0;
+        for (const auto& shard : shards_) {
+            std::scoped_lock lock(shard.mutex);
+            for (const auto& s : shard.strings) n += s.size();
+        }
+        return n;
+    }
+
+    /// Removes all strings from the pool and releases their memory.
+    /// All references returned by intern() and all interned_strings of this pool are invalidated,
+    /// the caller must ensure none of them are used afterwards.
+    void clear()
+    {
+        for (auto& shard : shards_) {
+            std::scoped_lock lock(shard.mutex);
+            shard.strings = {};
+        }
+    }
+
+    /// Returns the process wide pool, it is never cleared implicitly.
+    static key_pool& global() noexcept
+    {
+        static key_pool pool {};
+        return pool;
+    }
+
+    /// Returns the pool used by interned_string constructors without a pool argument
+    /// on the calling thread: the pool of the innermost active scope, or the global pool.
+    static key_pool& current() noexcept
+    {
+        auto* pool = current_pool();
+        return pool != nullptr ? *pool : global();
+    }
+
+private:
+    static constexpr std::size_t shard_count = 16;
+
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view s) const noexcept
+        { return std::hash<std::string_view>{}(s); }
+    };
+
+    struct alignas(64) shard
+    {
+        mutable std::mutex mutex {};
+        std::unordered_set<std::string, string_hash, std::equal_to<>> strings {};
+    };
+
+    static key_pool*& current_pool() noexcept
+    {
+        thread_local key_pool* pool = nullptr;
+        return pool;
+    }
+
+    std::array<shard, shard_count> shards_ {};
+};
+
+
+/// Makes a pool the current pool of the calling thread for the lifetime of the scope.
+///
+/// Values decoded with interning_bvalue_policy while the scope is active intern their keys
+/// in the given pool, which must outlive those values.
+/// @code
+/// bencode::key_pool pool {};
+/// {
+///     bencode::key_pool::scope s(pool);
+///     auto value = bencode::decode_value<bencode::interning_bvalue_policy>(data);
+/// }
+/// @endcode
+class key_pool::scope
+{
+public:
+    explicit scope(key_pool& pool) noexcept
+            : previous_(std::exchange(current_pool(), &pool))
+    {}
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    ~scope()
+    { current_pool() = previous_; }
+
+private:
+    key_pool* previous_;
+};
+
+
+/// Immutable string stored in a key_pool.
+///
+/// Equal strings interned in the same pool share storage,
+/// copies are pointer copies and equality is a pointer comparison when both operands
+/// come from the same pool. Ordering is lexicographical to keep dicts sorted.
+class interned_string
+{
+public:
+    using value_type = char;
+    using traits_type = std::char_traits<char>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator = std::string_view::const_iterator;
+    using iterator = const_iterator;
+
+    /// Construct an empty string.
+    interned_string() noexcept
+            : str_(&empty_string())
+    {}
+
+    /// Construct from s interned in the current pool of the thread, see key_pool::current().
+    interned_string(std::string_view s)
+            : str_(&key_pool::current().intern(s))
+    {}
+
+    interned_string(const std::string& s)
+            : interned_string(std::string_view(s))
+    {}
+
+    interned_string(const char* s)
+            : interned_string(std::string_view(s))
+    {}
+
+    /// Construct from s interned in the given pool.
+    interned_string(key_pool& pool, std::string_view s)
+            : str_(&pool.intern(s))
+    {}
+
+    const char* data() const noexcept
+    { return str_->data(); }
+
+    const char* c_str() const noexcept
+    { return str_->c_str(); }
+
+    size_type size() const noexcept
+    { return str_->size(); }
+
+    size_type length() const noexcept
+    { return str_->size(); }
+
+    bool empty() const noexcept
+    { return str_->empty(); }
+
+    const_iterator begin() const noexcept
+    { return view().begin(); }
+
+    const_iterator end() const noexcept
+    { return view().end(); }
+
+    std::string_view view() const noexcept
+    { return *str_; }
+
+    operator std::string_view() const noexcept
+    { return *str_; }
+
+    /// Returns the pooled string, two interned_strings from the same pool
+    /// are equal if and only if they return the same object.
+    const std::string& pooled() const noexcept
+    { return *str_; }
+
+    friend bool operator==(const interned_string& lhs, const interned_string& rhs) noexcept
+    { return lhs.str_ == rhs.str_ || *lhs.str_ == *rhs.str_; }
+
+    friend std::strong_ordering operator<=>(const interned_string& lhs, const interned_string& rhs) noexcept
+    {
+        if (lhs.str_ == rhs.str_) return std::strong_ordering::equal;
+        return lhs.view() <=> rhs.view();
+    }
+
+    friend bool operator==(const interned_string& lhs, std::string_view rhs) noexcept
+    { return lhs.view() == rhs; }
+
+    friend std::strong_ordering operator<=>(const interned_string& lhs, std::string_view rhs) noexcept
+    { return lhs.view() <=> rhs; }
+
+    friend bool operator==(const interned_string& lhs, const std::string& rhs) noexcept
+    { return lhs.view() == rhs; }
+
+    friend std::strong_ordering operator<=>(const interned_string& lhs, const std::string& rhs) noexcept
+    { return lhs.view() <=> std::string_view(rhs); }
+
+    friend bool operator==(const interned_string& lhs, const char* rhs) noexcept
+    { return lhs.view() == rhs; }
+
+    friend std::strong_ordering operator<=>(const interned_string& lhs, const char* rhs) noexcept
+    { return lhs.view() <=> std::string_view(rhs); }
+
+private:
+    static const std::string& empty_string() noexcept
+    {
+        static const std::string s {};
+        return s;
+    }
+
+    const std::string* str_;
+};
+
+
+namespace detail {
+
+struct interning_policy_helper
+{
+    template<typename V>
+    using list_type = std::vector<V>;
+
+    /// Dict keys are interned regardless of the string type of the policy.
+    template<typename K, typename V>
+    using dict_type = std::map<interned_string, V, std::less<>>;
+};
+
+} // namespace detail
+
+/// Policy storing dict keys as interned_string in the current key_pool of the thread,
+/// the global pool unless a key_pool::scope is active.
+/// Repeated keys of decoded values share a single copy
+/// and do not allocate after their first occurrence.
+struct interning_bvalue_policy
+        : bvalue_policy<
+            std::int64_t,
+            std::string_view,
+            std::string,
+            detail::interning_policy_helper::template list_type,
+            detail::interning_policy_helper::template dict_type
+        > {};
+
+} // namespace bencode
+
+
+template <>
+struct std::hash<bencode::interned_string>
+{
+    std::size_t operator()(const bencode::interned_string& s) const noexcept
+    { return std::hash<std::string_view>{}(s.view()); }
+};
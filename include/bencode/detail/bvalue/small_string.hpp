@@ -0,0 +1,393 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "bencode/detail/bvalue/bvalue_policy.hpp"
+
+namespace bencode {
+
+/// String with inline storage for up to N characters.
+///
+/// Strings longer than N characters are stored on the heap.
+/// The default capacity of 32 holds SHA-1 and SHA-256 digests, peer ids and node ids
+/// without allocating, where std::string allocates for strings over 15 characters.
+/// The interface is a subset of std::string.
+template <std::size_t N>
+class basic_small_string
+{
+    static_assert(N >= sizeof(char*), "inline capacity must be at least the size of a pointer");
+
+public:
+    using value_type = char;
+    using traits_type = std::char_traits<char>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = char&;
+    using const_reference = const char&;
+    using pointer = char*;
+    using const_pointer = const char*;
+    using iterator = char*;
+    using const_iterator = const char*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type npos = std::string_view::npos;
+    /// Number of characters stored without heap allocation.
+    static constexpr size_type inline_capacity = N;
+
+    basic_small_string() noexcept
+    { storage_.buffer[0] = '\0'; }
+
+    basic_small_string(const char* s)
+            : basic_small_string(std::string_view(s))
+    {}
+
+    basic_small_string(const char* s, size_type count)
+            : basic_small_string(std::string_view(s, count))
+    {}
+
+    explicit basic_small_string(std::string_view s)
+            : basic_small_string()
+    { append(s); }
+
+    explicit basic_small_string(const std::string& s)
+            : basic_small_string(std::string_view(s))
+    {}
+
+    basic_small_string(size_type count, char c)
+            : basic_small_string()
+    { resize(count, c); }
+
+    template <std::input_iterator InputIt, std::sentinel_for<InputIt> Sentinel>
+    basic_small_string(InputIt first, Sentinel last)
+            : basic_small_string()
+    {
+        if constexpr (std::contiguous_iterator<InputIt> && std::sized_sentinel_for<Sentinel, InputIt>) {
+            append(std::string_view(std::to_address(first), static_cast<size_type>(last - first)));
+        }
+        else {
+            for (; first != last; ++first) push_back(*first);
+        }
+    }
+
+    basic_small_string(std::initializer_list<char> il)
+            : basic_small_string(il.begin(), il.end())
+    {}
+
+    basic_small_string(const basic_small_string& other)
+            : basic_small_string(other.view())
+    {}
+
+    basic_small_string(basic_small_string&& other) noexcept
+            : size_(other.size_)
+            , capacity_(other.capacity_)
+    {
+        if (other.is_inline()) {
+            std::memcpy(storage_.buffer, other.storage_.buffer, size_ + 1);
+        }
+        else {
+            storage_.heap = other.storage_.heap;
+            other.capacity_ = N;
+        }
+        other.size_ = 0;
+        other.storage_.buffer[0] = '\0';
+    }
+
+    basic_small_string& operator=(const basic_small_string& other)
+    {
+        if (this != &other) assign(other.view());
+        return *this;
+    }
+
+    basic_small_string& operator=(basic_small_string&& other) noexcept
+    {
+        if (this != &other) {
+            this->~basic_small_string();
+            new (this) basic_small_string(std::move(other));
+        }
+        return *this;
+    }
+
+    basic_small_string& operator=(std::string_view s)
+    { return assign(s); }
+
+    basic_small_string& operator=(const char* s)
+    { return assign(std::string_view(s)); }
+
+    ~basic_small_string()
+    {
+        if (!is_inline()) delete[] storage_.heap;
+    }
+
+    basic_small_string& assign(std::string_view s)
+    {
+        // s may refer to our own storage
+        if (s.size() > capacity_) {
+            basic_small_string tmp(s);
+            swap(tmp);
+        }
+        else {
+            traits_type::move(data(), s.data(), s.size());
+            set_size(s.size());
+        }
+        return *this;
+    }
+
+    // element access
+
+    reference operator[](size_type pos) noexcept
+    { return data()[pos]; }
+
+    const_reference operator[](size_type pos) const noexcept
+    { return data()[pos]; }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size_) throw std::out_of_range("basic_small_string::at");
+        return data()[pos];
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size_) throw std::out_of_range("basic_small_string::at");
+        return data()[pos];
+    }
+
+    reference front() noexcept
+    { return data()[0]; }
+
+    const_reference front() const noexcept
+    { return data()[0]; }
+
+    reference back() noexcept
+    { return data()[size_ - 1]; }
+
+    const_reference back() const noexcept
+    { return data()[size_ - 1]; }
+
+    char* data() noexcept
+    { return is_inline() ? storage_.buffer : storage_.heap; }
+
+    const char* data() const noexcept
+    { return is_inline() ? storage_.buffer : storage_.heap; }
+
+    const char* c_str() const noexcept
+    { return data(); }
+
+    std::string_view view() const noexcept
+    { return {data(), size_}; }
+
+    operator std::string_view() const noexcept
+    { return view(); }
+
+    // iterators
+
+    iterator begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator cbegin() const noexcept { return data(); }
+    iterator end() noexcept { return data() + size_; }
+    const_iterator end() const noexcept { return data() + size_; }
+    const_iterator cend() const noexcept { return data() + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // capacity
+
+    bool empty() const noexcept
+    { return size_ == 0; }
+
+    size_type size() const noexcept
+    { return size_; }
+
+    size_type length() const noexcept
+    { return size_; }
+
+    size_type max_size() const noexcept
+    { return std::numeric_limits<difference_type>::max() - 1; }
+
+    size_type capacity() const noexcept
+    { return capacity_; }
+
+    /// Returns true when the characters are stored inside the object.
+    bool is_inline() const noexcept
+    { return capacity_ == N; }
+
+    void reserve(size_type new_capacity)
+    {
+        if (new_capacity <= capacity_) return;
+
+        auto* p = new char[new_capacity + 1];
+        std::memcpy(p, data(), size_ + 1);
+        if (!is_inline()) delete[] storage_.heap;
+        storage_.heap = p;
+        capacity_ = new_capacity;
+    }
+
+    void shrink_to_fit()
+    {
+        if (is_inline() || size_ == capacity_) return;
+        basic_small_string tmp(view());
+        swap(tmp);
+    }
+
+    // operations
+
+    void clear() noexcept
+    { set_size(0); }
+
+    void push_back(char c)
+    {
+        grow_to(size_ + 1);
+        data()[size_] = c;
+        set_size(size_ + 1);
+    }
+
+    void pop_back() noexcept
+    { set_size(size_ - 1); }
+
+    basic_small_string& append(std::string_view s)
+    {
+        if (s.empty()) return *this;
+        if (size_ + s.size() > capacity_) {
+            // copy first, s may refer to our own storage
+            basic_small_string tmp {};
+            tmp.reserve(empty() ? s.size() : std::max(size_ + s.size(), 2 * capacity_));
+            std::memcpy(tmp.data(), data(), size_);
+            std::memcpy(tmp.data() + size_, s.data(), s.size());
+            tmp.set_size(size_ + s.size());
+            swap(tmp);
+        }
+        else {
+            traits_type::move(data() + size_, s.data(), s.size());
+            set_size(size_ + s.size());
+        }
+        return *this;
+    }
+
+    basic_small_string& append(size_type count, char c)
+    {
+        resize(size_ + count, c);
+        return *this;
+    }
+
+    basic_small_string& operator+=(std::string_view s)
+    { return append(s); }
+
+    basic_small_string& operator+=(const char* s)
+    { return append(std::string_view(s)); }
+
+    basic_small_string& operator+=(char c)
+    {
+        push_back(c);
+        return *this;
+    }
+
+    void resize(size_type count, char c = '\0')
+    {
+        if (count > size_) {
+            grow_to(count);
+            std::memset(data() + size_, c, count - size_);
+        }
+        set_size(count);
+    }
+
+    void swap(basic_small_string& other) noexcept
+    {
+        basic_small_string tmp(std::move(other));
+        other.~basic_small_string();
+        new (&other) basic_small_string(std::move(*this));
+        this->~basic_small_string();
+        new (this) basic_small_string(std::move(tmp));
+    }
+
+    friend void swap(basic_small_string& lhs, basic_small_string& rhs) noexcept
+    { lhs.swap(rhs); }
+
+    // comparison
+
+    friend bool operator==(const basic_small_string& lhs, const basic_small_string& rhs) noexcept
+    { return lhs.view() == rhs.view(); }
+
+    friend std::strong_ordering operator<=>(const basic_small_string& lhs, const basic_small_string& rhs) noexcept
+    { return lhs.view() <=> rhs.view(); }
+
+    friend bool operator==(const basic_small_string& lhs, std::string_view rhs) noexcept
+    { return lhs.view() == rhs; }
+
+    friend std::strong_ordering operator<=>(const basic_small_string& lhs, std::string_view rhs) noexcept
+    { return lhs.view() <=> rhs; }
+
+    friend bool operator==(const basic_small_string& lhs, const char* rhs) noexcept
+    { return lhs.view() == std::string_view(rhs); }
+
+    friend std::strong_ordering operator<=>(const basic_small_string& lhs, const char* rhs) noexcept
+    { return lhs.view() <=> std::string_view(rhs); }
+
+    friend bool operator==(const basic_small_string& lhs, const std::string& rhs) noexcept
+    { return lhs.view() == std::string_view(rhs); }
+
+    friend std::strong_ordering operator<=>(const basic_small_string& lhs, const std::string& rhs) noexcept
+    { return lhs.view() <=> std::string_view(rhs); }
+
+private:
+    void set_size(size_type n) noexcept
+    {
+        size_ = n;
+        data()[n] = '\0';
+    }
+
+    void grow_to(size_type n)
+    {
+        if (n > capacity_) reserve(std::max(n, 2 * capacity_));
+    }
+
+    size_type size_ = 0;
+    /// N when the characters are stored inline
+    size_type capacity_ = N;
+    union {
+        char buffer[N + 1];
+        char* heap;
+    } storage_;
+};
+
+
+/// String type with 32 characters of inline storage.
+using small_string = basic_small_string<32>;
+
+
+/// Policy storing strings and dict keys as small_string.
+/// Strings up to 32 characters, such as info hashes, node ids and peer ids, do not allocate.
+struct small_string_bvalue_policy
+        : bvalue_policy<
+            std::int64_t,
+            std::string_view,
+            small_string,
+            detail::default_policy_helper::template list_type,
+            detail::default_policy_helper::template dict_type
+        > {};
+
+} // namespace bencode
+
+
+template <std::size_t N>
+struct std::hash<bencode::basic_small_string<N>>
+{
+    std::size_t operator()(const bencode::basic_small_string<N>& s) const noexcept
+    { return std::hash<std::string_view>{}(s.view()); }
+};
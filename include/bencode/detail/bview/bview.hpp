@@ -78,16 +78,35 @@ public:
     /// @returns Bencoded representation of the described value.
     constexpr std::string_view bencoded_view() const noexcept
     {
-        if (desc_->is_integer())
-            return {buffer_, detail::base_ten_digits(desc_->value()) + 2 };
+        const char* first = buffer_ + desc_->position();
+
+        if (desc_->is_integer()) {
+            const auto v = desc_->value();
+            const auto magnitude = v < 0 ? std::uint64_t(0) - static_cast<std::uint64_t>(v)
+                                         : static_cast<std::uint64_t>(v);
+            const auto digits = v == 0 ? 1 : detail::base_ten_digits(magnitude);
+            return {first, digits + (v < 0) + 2};
+        }
         else if (desc_->is_string())
-            return {buffer_, desc_->offset() + desc_->size()};
+            return {first, desc_->offset() + desc_->size()};
         else {
             auto end_desc = std::next(desc_, desc_->offset());
-            return {buffer_, end_desc->position() + 1 - desc_->position()};
+            return {first, end_desc->position() + 1 - desc_->position()};
         }
     }
 
+    /// Returns true if the bencoded representation is known to be canonical.
+    /// Integers and strings are always canonical since the parser rejects leading zeros
+    /// in integers and string lengths, lists and dicts when the parser
+    /// found all keys of nested dicts in strictly increasing order.
+    /// Canonical values compare equal if and only if their bencoded representations are equal.
+    constexpr bool is_canonical() const noexcept
+    {
+        if (desc_ == nullptr) return false;
+        if (desc_->is_integer() || desc_->is_string()) return true;
+        return desc_->is_canonical();
+    }
+
     constexpr bool operator==(const bview& that) const noexcept
     {
         // defined in compare in avoid circular dependency with accessors
@@ -42,7 +42,7 @@ constexpr auto compare_equality_with_bview_default_string_impl(
 }
 
 template <typename T>
-constexpr auto compare_equality_with_bvalue_default_string_impl(
+constexpr auto compare_equality_with_bview_default_string_impl(
         customization_point_type<T>,
         const bview& bv,
         const T& value,
@@ -50,7 +50,7 @@ constexpr auto compare_equality_with_bvalue_default_string_impl(
 {
     if (!is_string(bv)) return false;
     const auto& s = get_string(bv);
-    return std::lexicographical_compare(
+    return std::equal(
             rng::begin(s), rng::end(s),
             rng::begin(value), rng::end(value));
 }
@@ -143,12 +143,13 @@ constexpr auto compare_three_way_with_bview_default_list_impl(
         const T& value,
         priority_tag<0>) -> std::weak_ordering
 {
-    if (!is_string(b)) return (b.type() <=> bencode_type::string);
+    if (!is_list(b)) return (b.type() <=> bencode_type::list);
     const auto& blist = get_list(b);
 
     return std::lexicographical_compare_three_way(
             rng::begin(blist), rng::end(blist),
-            rng::begin(value), rng::end(value));
+            rng::begin(value), rng::end(value),
+            [](const bview& lhs, const auto& rhs) -> std::weak_ordering { return lhs <=> rhs; });
 }
 
 template <typename T>
@@ -217,7 +218,7 @@ constexpr bool compare_equality_with_bview(const bview& bv, const T& value)
         }
         else if constexpr (bencode::serialization_traits<T>::type == bencode_type::string) {
             return compare_equality_with_bview_default_string_impl(
-                    customization_for<T>, bv,value, priority_tag<0>{});
+                    customization_for<T>, bv,value, priority_tag<1>{});
         }
         else if constexpr (bencode::serialization_traits<T>::type == bencode_type::list) {
             return compare_equality_with_bview_default_list_impl(
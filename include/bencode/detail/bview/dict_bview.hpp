@@ -2,11 +2,15 @@
 
 #include <algorithm>
 #include <iterator>
+#include <span>
+#include <string_view>
 #include <utility>
+#include <vector>
 #include <gsl/gsl_assert>
 #include <compare>
 
 #include "bencode/detail/symbol.hpp"
+#include "bencode/detail/key_literal.hpp"
 #include "bencode/detail/bview/bview.hpp"
 #include "bencode/detail/bview/string_bview.hpp"
 
@@ -172,6 +176,14 @@ public:
         throw std::out_of_range("no item with given key found");
     }
 
+    /// @copydoc at(std::string_view) const
+    constexpr auto at(const key_literal& key) const -> mapped_type
+    {
+        if (auto it = find(key); it != end())
+            return it.value();
+        throw std::out_of_range("no item with given key found");
+    }
+
     // iterator support
 
     /// Returns an iterator to the first element of the dict_bview.
@@ -247,7 +259,7 @@ public:
     /// i.e. std::distance(begin(), end()) for the largest container.
     /// @returns Maximum number of elements.
     constexpr std::size_t max_size() const noexcept
-    { return std::numeric_limits<decltype(std::declval<descriptor>().size())>::max(); }
+    { return std::numeric_limits<std::uint32_t>::max(); }
 
     // lookup
 
@@ -276,6 +288,74 @@ public:
         return it;
     }
 
+    /// Finds the elements with keys equivalent to each of the keys in sorted_keys.
+    /// Dicts with sorted keys are merge-joined with sorted_keys in a single pass
+    /// that stops after the last requested key, other dicts are searched by looking up
+    /// every dict key in sorted_keys. As with find(), the first matching element is returned.
+    /// @param sorted_keys the keys to search for, in increasing order
+    /// @param out receives the value of the element with key sorted_keys[i] at out[i],
+    ///            or an uninitialized bview if no such element is found.
+    /// @complexity Linear in the size of the container plus the number of keys when the dict
+    ///             has sorted keys, otherwise the size of the container times the logarithm
+    ///             of the number of keys.
+    constexpr void find_many(std::span<const std::string_view> sorted_keys, std::span<bview> out) const noexcept
+    {
+        Expects(out.size() >= sorted_keys.size());
+        Expects(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+
+        const std::size_t n = sorted_keys.size();
+        std::fill_n(out.begin(), n, bview{});
+
+        if (has_sorted_keys()) {
+            std::size_t i = 0;
+            for (auto it = begin(); it != end() && i < n; ++it) {
+                const auto key = std::string_view(it.key());
+                for (; i < n; ++i) {
+                    const int c = sorted_keys[i].compare(key);
+                    if (c > 0) break;
+                    if (c == 0) out[i] = it.value();
+                }
+            }
+            return;
+        }
+
+        for (auto it = begin(); it != end(); ++it) {
+            const auto key = std::string_view(it.key());
+            auto [first, last] = std::equal_range(sorted_keys.begin(), sorted_keys.end(), key);
+            for (; first != last; ++first) {
+                auto& v = out[static_cast<std::size_t>(first - sorted_keys.begin())];
+                if (v.type() == bencode_type::uninitialized) v = it.value();
+            }
+        }
+    }
+
+    /// Finds the elements with keys equivalent to each of the keys in sorted_keys.
+    /// @param sorted_keys the keys to search for, in increasing order
+    /// @returns a vector with the value of the element with key sorted_keys[i] at index i,
+    ///          or an uninitialized bview if no such element is found.
+    /// @see find_many(std::span<const std::string_view>, std::span<bview>)
+    std::vector<bview> find_many(std::span<const std::string_view> sorted_keys) const
+    {
+        std::vector<bview> out(sorted_keys.size());
+        find_many(sorted_keys, out);
+        return out;
+    }
+
+    /// Finds an element with key equivalent to key.
+    /// Candidate keys with a different length or prefix are rejected without comparing their bytes.
+    /// @param key value of the element to search for
+    /// @returns Iterator to an element with key equivalent to key.
+    ///          If no such element is found, past-the-end (see end()) iterator is returned.
+    /// @complexity linear in the size of the container.
+    constexpr const_iterator find(const key_literal& key) const noexcept
+    {
+        auto it = begin();
+        for ( ; it != end(); ++it) {
+            if (key.matches(std::string_view(it.key()))) return it;
+        }
+        return it;
+    }
+
     /// Checks if there is an element with key equivalent to key in the container.
     /// @param key value of the element to search for
     /// @returns true if there is such an element, otherwise false.
@@ -283,6 +363,27 @@ public:
     constexpr bool contains(std::string_view key) const noexcept
     { return count(key) > 0; }
 
+    /// @copydoc contains(std::string_view) const
+    constexpr bool contains(const key_literal& key) const noexcept
+    { return find(key) != end(); }
+
+    /// Checks if the keys are in strictly increasing order, as required by canonical bencode.
+    /// @returns true if the keys are sorted and unique, otherwise false.
+    /// @complexity Constant if the dict is known to be canonical, otherwise linear in the size of the container.
+    constexpr bool has_sorted_keys() const noexcept
+    {
+        if (is_canonical() || empty()) return true;
+
+        auto it = begin();
+        auto prev = std::string_view(it.key());
+        for (++it; it != end(); ++it) {
+            const auto key = std::string_view(it.key());
+            if (!(prev < key)) return false;
+            prev = key;
+        }
+        return true;
+    }
+
     /// Returns a range containing all elements with the given key in the container.
     /// The range is defined by two iterators, one pointing to the first element
     /// that is not less than key and another pointing to the first element greater than key.
@@ -319,6 +420,8 @@ public:
     /// Compare equality with a dict_bview.
     ///@param rhs a value to compare
     constexpr bool operator==(const dict_bview& rhs) const noexcept {
+        if (is_canonical() && rhs.is_canonical())
+            return bencoded_view() == rhs.bencoded_view();
         return std::equal(begin(), end(), rhs.begin(), rhs.end());
     }
 
@@ -326,6 +429,9 @@ public:
     ///@param rhs a value to compare
     constexpr std::weak_ordering operator<=>(const dict_bview& rhs) const noexcept
     {
+        // skip equal subtrees, bytes do not order integers and strings by value
+        if (is_canonical() && rhs.is_canonical() && bencoded_view() == rhs.bencoded_view())
+            return std::weak_ordering::equivalent;
         return std::lexicographical_compare_three_way(begin(), end(), rhs.begin(), rhs.end());
     }
 
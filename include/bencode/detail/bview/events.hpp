@@ -14,6 +14,7 @@
 #include "bencode/detail/concepts.hpp"
 #include "bencode/detail/utils.hpp"
 #include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/events/traversal.hpp"
 
 
 namespace bencode::detail {
@@ -40,6 +41,33 @@ constexpr void connect_events_default_string_impl(
     consumer.string(std::string_view(desc));
 }
 
+/// Traversal traits for bview, nodes are views into the descriptor table.
+struct bview_traversal_traits
+{
+    using node = bview;
+    using list_iterator = list_bview_iterator;
+    using dict_iterator = dict_bview_iterator;
+    static constexpr bool sized_end = true;
+
+    static constexpr bencode_type type(const bview& n) noexcept { return n.type(); }
+    static constexpr std::int64_t integer(const bview& n)
+    { return static_cast<std::int64_t>(get_integer(n)); }
+    static constexpr std::string_view string(const bview& n)
+    { return std::string_view(get_string(n)); }
+    static constexpr std::size_t size(const bview& n)
+    { return n.type() == bencode_type::list ? rng::size(get_list(n)) : rng::size(get_dict(n)); }
+
+    static constexpr list_iterator list_begin(const bview& n) { return rng::begin(get_list(n)); }
+    static constexpr list_iterator list_end(const bview& n) { return rng::end(get_list(n)); }
+    static constexpr dict_iterator dict_begin(const bview& n) { return rng::begin(get_dict(n)); }
+    static constexpr dict_iterator dict_end(const bview& n) { return rng::end(get_dict(n)); }
+
+    static constexpr bview list_item(const list_iterator& it) { return *it; }
+    static constexpr std::string_view dict_key(const dict_iterator& it)
+    { return std::string_view(it.key()); }
+    static constexpr bview dict_value(const dict_iterator& it) { return it.value(); }
+};
+
 template <event_consumer EC>
 constexpr void connect_events_default_list_impl(
         customization_point_type<list_bview>,
@@ -47,12 +75,7 @@ constexpr void connect_events_default_list_impl(
         const list_bview& desc,
         detail::priority_tag<0>)
 {
-    consumer.begin_list(rng::size(desc));
-    for (const auto& e : desc) {
-        connect(consumer, e);
-        consumer.list_item();
-    }
-    consumer.end_list(rng::size(desc));
+    connect_iterative<bview_traversal_traits>(consumer, desc);
 }
 
 template <event_consumer EC>
@@ -62,14 +85,7 @@ constexpr void connect_events_default_dict_impl(
         const dict_bview& desc,
         detail::priority_tag<0>)
 {
-        consumer.begin_dict(rng::size(desc));
-        for (auto it = rng::begin(desc); it != rng::end(desc); ++it) {
-            consumer.string(it.key());
-            consumer.dict_key();
-            connect(consumer, it.value());
-            consumer.dict_value();
-        }
-        consumer.end_dict(rng::size(desc));
+    connect_iterative<bview_traversal_traits>(consumer, desc);
 }
 
 
@@ -80,13 +96,8 @@ constexpr void connect_events_default_runtime_impl(
         const bview& bref,
         detail::priority_tag<1>)
 {
-    switch (bref.type()) {
-        case bencode_type::integer:  connect(consumer, get_integer(bref)); break;
-        case bencode_type::string:   connect(consumer, get_string(bref));  break;
-        case bencode_type::list:     connect(consumer, get_list(bref));    break;
-        case bencode_type::dict:     connect(consumer, get_dict(bref));    break;
-        default: Ensures(false);
-    }
+    Expects(bref.type() != bencode_type::uninitialized);
+    connect_iterative<bview_traversal_traits>(consumer, bref);
 }
 
 }
\ No newline at end of file
@@ -231,7 +231,7 @@ public:
     /// i.e. std::distance(begin(), end()) for the largest container.
     /// @returns Maximum number of elements.
     constexpr size_type max_size() const noexcept
-    { return std::numeric_limits<decltype(std::declval<descriptor>().size())>::max(); }
+    { return std::numeric_limits<std::uint32_t>::max(); }
 
 //-------------------------------------------------------------------------------------------------
 // element access
@@ -291,6 +291,8 @@ public:
     ///@param rhs a bvalue to compare
     constexpr bool operator==(const list_bview& rhs) const noexcept
     {
+        if (is_canonical() && rhs.is_canonical())
+            return bencoded_view() == rhs.bencoded_view();
         return std::equal(begin(), end(), rhs.begin(), rhs.end());
     }
 
@@ -298,6 +300,9 @@ public:
     ///@param rhs a bvalue to compare
     constexpr std::weak_ordering operator<=>(const list_bview& rhs) const noexcept
     {
+        // skip equal subtrees, bytes do not order integers and strings by value
+        if (is_canonical() && rhs.is_canonical() && bencoded_view() == rhs.bencoded_view())
+            return std::weak_ordering::equivalent;
         return std::lexicographical_compare_three_way(begin(), end(), rhs.begin(), rhs.end());
     }
 
@@ -146,7 +146,7 @@ public:
     /// The largest possible number of char-like objects that can be referred to by a string_bview.
     /// @returns Maximum number of characters.
     constexpr size_type max_size() const noexcept
-    { return std::numeric_limits<decltype(desc_->size())>::max(); }
+    { return descriptor::max_string_size; }
 
     /// Checks if the view has no characters, i.e. whether size() == 0.
     /// @returns true if the view is empty, false otherwise
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/// @file Fast non-cryptographic hashing of byte sequences.
+
+namespace bencode::detail {
+
+/// Incremental 64-bit hash of a byte sequence, based on the wyhash mixing function.
+///
+/// The result only depends on the bytes passed to update(), not on how they are split
+/// over calls, so a value can be hashed while it is encoded without buffering the encoding.
+/// Hash values are not stable across platforms with different endianness
+/// and must not be persisted.
+class byte_hasher
+{
+public:
+    explicit constexpr byte_hasher(std::uint64_t seed = 0) noexcept
+            : state_(seed ^ mix(seed ^ p0, p1))
+    {}
+
+    /// Add a single byte.
+    constexpr void update(char c) noexcept
+    {
+        buffer_[buffer_size_++] = c;
+        if (buffer_size_ == block_size) {
+            consume_block(buffer_.data());
+            buffer_size_ = 0;
+        }
+        ++length_;
+    }
+
+    /// Add a sequence of bytes.
+    constexpr void update(std::string_view bytes) noexcept
+    {
+        const char* first = bytes.data();
+        std::size_t n = bytes.size();
+        length_ += n;
+
+        // complete a partially filled block first
+        if (buffer_size_ != 0) {
+            const auto k = std::min(n, block_size - buffer_size_);
+            copy(buffer_.data() + buffer_size_, first, k);
+            buffer_size_ += k;
+            first += k;
+            n -= k;
+            if (buffer_size_ != block_size) return;
+            consume_block(buffer_.data());
+            buffer_size_ = 0;
+        }
+        for (; n >= block_size; first += block_size, n -= block_size) {
+            consume_block(first);
+        }
+        copy(buffer_.data(), first, n);
+        buffer_size_ = n;
+    }
+
+    /// Returns the hash of all bytes added so far.
+    constexpr std::uint64_t digest() const noexcept
+    {
+        std::array<char, block_size> tail {};
+        copy(tail.data(), buffer_.data(), buffer_size_);
+        const auto a = read64(tail.data());
+        const auto b = read64(tail.data() + 8);
+        return mix(p1 ^ length_, mix(a ^ p1, b ^ state_));
+    }
+
+private:
+    static constexpr std::size_t block_size = 16;
+
+    static constexpr std::uint64_t p0 = 0xa0761d6478bd642full;
+    static constexpr std::uint64_t p1 = 0xe7037ed1a0b428dbull;
+    static constexpr std::uint64_t p2 = 0x8ebc6af09c88c6e3ull;
+
+    /// Xor of the high and low half of the 128-bit product of a and b.
+    static constexpr std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        const auto r = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+        const std::uint64_t ha = a >> 32, hb = b >> 32, la = std::uint32_t(a), lb = std::uint32_t(b);
+        const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        const std::uint64_t t = rl + (rm0 << 32);
+        const std::uint64_t lo = t + (rm1 << 32);
+        const std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+        return lo ^ hi;
+#endif
+    }
+
+    static constexpr std::uint64_t read64(const char* p) noexcept
+    {
+        std::uint64_t v = 0;
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < 8; ++i)
+                v |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        else {
+            std::memcpy(&v, p, sizeof(v));
+        }
+        return v;
+    }
+
+    static constexpr void copy(char* dst, const char* src, std::size_t n) noexcept
+    {
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < n; ++i) dst[i] = src[i];
+        }
+        else if (n != 0) {
+            std::memcpy(dst, src, n);
+        }
+    }
+
+    constexpr void consume_block(const char* p) noexcept
+    {
+        state_ = mix(read64(p) ^ p1, read64(p + 8) ^ state_ ^ p2);
+    }
+
+    std::uint64_t state_;
+    std::uint64_t length_ = 0;
+    std::array<char, block_size> buffer_ {};
+    std::size_t buffer_size_ = 0;
+};
+
+/// Hash a contiguous sequence of bytes.
+constexpr std::uint64_t hash_bytes(std::string_view bytes, std::uint64_t seed = 0) noexcept
+{
+    byte_hasher h(seed);
+    h.update(bytes);
+    return h.digest();
+}
+
+} // namespace bencode::detail
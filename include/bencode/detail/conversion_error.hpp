@@ -3,6 +3,7 @@
 #include <exception>
 #include <stdexcept>
 #include <string_view>
+#include <system_error>
 
 namespace bencode {
 
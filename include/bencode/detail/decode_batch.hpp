@@ -0,0 +1,121 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <nonstd/expected.hpp>
+
+#include "bencode/detail/bvalue/basic_bvalue.hpp"
+#include "bencode/detail/bvalue/interned_string.hpp"
+#include "bencode/detail/descriptor_table.hpp"
+#include "bencode/detail/events/to_bvalue.hpp"
+#include "bencode/detail/parser/descriptor_parser.hpp"
+#include "bencode/detail/parser/push_parser.hpp"
+#include "bencode/detail/work_stealing_pool.hpp"
+
+namespace bencode {
+
+/// Result of decoding one document of a batch: the decoded data or the parsing error.
+template <typename T>
+using batch_result = nonstd::expected<T, parsing_error>;
+
+namespace detail {
+
+/// Process wide pool used by the batch decode functions.
+inline work_stealing_pool& default_decode_pool()
+{
+    static work_stealing_pool pool {};
+    return pool;
+}
+
+/// to_bvalue consumer that leaves error reporting to the parser instead of throwing.
+template <typename Policy>
+struct batch_to_bvalue : events::to_bvalue<Policy>
+{
+    void error(const bencode::parsing_error&) noexcept {}
+};
+
+} // namespace detail
+
+
+/// Decode many independent documents to descriptor tables in parallel.
+///
+/// Documents are distributed over the workers of a work-stealing thread pool.
+/// Each worker reuses one descriptor_parser and its descriptor buffer for all documents
+/// it processes, so every descriptor_table is allocated once with its exact size.
+/// The descriptor tables refer to the input data, which must outlive the results.
+/// @param inputs the bencoded documents
+/// @param options parser options applied to each document
+/// @param pool the thread pool to run on
+/// @returns the decoded documents or parsing errors, in the order of the input.
+inline std::vector<batch_result<descriptor_table>>
+decode_view_batch(std::span<const std::string_view> inputs,
+                  const parser_options& options,
+                  work_stealing_pool& pool)
+{
+    std::vector<batch_result<descriptor_table>> results(inputs.size());
+    std::vector<descriptor_parser<>> parsers(pool.concurrency(), descriptor_parser<>(options));
+
+    pool.for_each_index(inputs.size(), [&](std::size_t worker, std::size_t i) {
+        auto& parser = parsers[worker];
+        if (auto r = parser.parse_reusing_buffer(inputs[i]); r) [[likely]]
+            results[i] = std::move(*r);
+        else
+            results[i] = nonstd::make_unexpected(parser.error());
+    });
+    return results;
+}
+
+/// @copydoc decode_view_batch
+/// Runs on a process wide pool with one worker per hardware thread.
+inline std::vector<batch_result<descriptor_table>>
+decode_view_batch(std::span<const std::string_view> inputs, const parser_options& options = {})
+{
+    return decode_view_batch(inputs, options, detail::default_decode_pool());
+}
+
+
+/// Decode many independent documents to basic_bvalue instances in parallel.
+///
+/// Documents are distributed over the workers of a work-stealing thread pool.
+/// Each worker reuses one push_parser for all documents it processes.
+/// Workers intern keys in the current key_pool of the calling thread, see key_pool::scope.
+/// @tparam Policy the policy template argument for basic_bvalue,
+///     defaults to default_bvalue_policy.
+/// @param inputs the bencoded documents
+/// @param options parser options applied to each document
+/// @param pool the thread pool to run on
+/// @returns the decoded documents or parsing errors, in the order of the input.
+template <typename Policy = default_bvalue_policy>
+inline std::vector<batch_result<basic_bvalue<Policy>>>
+decode_value_batch(std::span<const std::string_view> inputs,
+                   const parser_options& options,
+                   work_stealing_pool& pool)
+{
+    std::vector<batch_result<basic_bvalue<Policy>>> results(inputs.size());
+    std::vector<push_parser<>> parsers(pool.concurrency(), push_parser<>(options));
+    auto& keys = key_pool::current();
+
+    pool.for_each_index(inputs.size(), [&](std::size_t worker, std::size_t i) {
+        auto& parser = parsers[worker];
+        key_pool::scope key_scope(keys);
+        detail::batch_to_bvalue<Policy> consumer;
+        if (parser.parse(consumer, inputs[i])) [[likely]]
+            results[i] = consumer.value();
+        else
+            results[i] = nonstd::make_unexpected(parser.error());
+    });
+    return results;
+}
+
+/// @copydoc decode_value_batch
+/// Runs on a process wide pool with one worker per hardware thread.
+template <typename Policy = default_bvalue_policy>
+inline std::vector<batch_result<basic_bvalue<Policy>>>
+decode_value_batch(std::span<const std::string_view> inputs, const parser_options& options = {})
+{
+    return decode_value_batch<Policy>(inputs, options, detail::default_decode_pool());
+}
+
+} // namespace bencode
@@ -25,6 +25,8 @@ namespace rng = std::ranges;
 template <typename Policy = default_bvalue_policy>
 inline basic_bvalue<Policy> decode_value(std::istream& is)
 {
+    static_assert(!detail::borrowing_policy<Policy>,
+                  "values of a borrowing policy must be decoded from a contiguous buffer");
     auto consumer = bencode::events::to_bvalue<Policy>{};
     push_parser<std::istreambuf_iterator<char>> parser {};
 
@@ -73,6 +75,15 @@ inline basic_bvalue<Policy> decode_value(const Rng& range)
     return consumer.value();
 }
 
+/// Decoding a temporary buffer to a borrowing policy would leave the value
+/// with dangling strings, the buffer must outlive the value.
+template <typename Policy = default_bvalue_policy, rng::input_range Rng>
+/// \cond CONCEPTS
+    requires detail::borrowing_policy<Policy> &&
+             (!std::is_lvalue_reference_v<Rng>) && (!rng::borrowed_range<Rng>)
+/// \endcond
+basic_bvalue<Policy> decode_value(Rng&& range) = delete;
+
 /// Reads bencoded data from a pair of iterators to a basic_bvalue.
 /// @tparam Policy the policy template argument for basic_bvalue,
 ///     defaults to default_bvalue_policy.
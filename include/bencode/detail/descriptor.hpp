@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <vector>
 #include <stack>
 #include <algorithm>
@@ -40,6 +41,10 @@ enum class descriptor_type : std::uint8_t
 };
 
 /// class describing the value and metadata contained in bencoded tokens.
+///
+/// Positions are stored with 48 bits and string sizes with 40 bits, using the padding after
+/// the type field for the high bits, so documents and strings larger than 4 GiB
+/// can be described without increasing the size of a descriptor.
 class descriptor
 {
 private:
@@ -74,20 +79,34 @@ private:
     };
 
 public:
+    /// Largest position in the bencoded buffer that can be stored.
+    static constexpr std::uint64_t max_position = (std::uint64_t(1) << 48) - 1;
+    /// Largest string size that can be stored.
+    static constexpr std::uint64_t max_string_size = (std::uint64_t(1) << 40) - 1;
+
     template <typename... Args>
-    constexpr descriptor(descriptor_type type, std::size_t position, Args... args) noexcept
+    constexpr descriptor(descriptor_type type, std::uint64_t position, Args... args) noexcept
             : type_(type)
-            , position_(position)
+            , size_high_(0)
+            , position_high_(static_cast<std::uint16_t>(position >> 32))
+            , position_(static_cast<std::uint32_t>(position))
             , data_()
     {
+        Expects(position <= max_position);
+
         if constexpr(sizeof...(Args) == 0) {}
         else if constexpr(sizeof...(Args) == 1) {
             if (is_integer())
                 data_.integer = {args...};
         }
         else if constexpr (sizeof...(Args) == 2) {
-            if (is_string() || is_list() || is_dict())
-                data_.structured = {static_cast<std::uint32_t>(args)...};
+            if (is_string() || is_list() || is_dict()) {
+                const std::uint64_t values[] = {static_cast<std::uint64_t>(args)...};
+                data_.structured = {static_cast<std::uint32_t>(values[0]),
+                                    static_cast<std::uint32_t>(values[1])};
+                if (is_string())
+                    size_high_ = static_cast<std::uint8_t>(values[1] >> 32);
+            }
         }
         else {
             static_assert((detail::always_false_v<Args> || ...), "invalid number of arguments");
@@ -163,8 +182,8 @@ public:
     { return (type_ & descriptor_type::dict_value) == descriptor_type::dict_value; }
 
     /// Returns the position in the bencoded buffer of the start of the token.
-    constexpr auto position() const noexcept -> std::uint32_t
-    { return position_; }
+    constexpr auto position() const noexcept -> std::uint64_t
+    { return (std::uint64_t(position_high_) << 32) | position_; }
 
     /// Returns the value of an integer token,
     /// Behavior is undefined if the data type is not an integer.
@@ -185,18 +204,45 @@ public:
 
     /// Returns the size of a string, list or dict data type.
     /// Behavior is undefined if the data type is an integer.
-    constexpr auto size() const noexcept -> std::uint32_t
+    constexpr auto size() const noexcept -> std::uint64_t
     {
         Expects(is_string() || is_list_begin() || is_dict_begin());
-        return data_.structured.size;
+        if (!is_string()) return data_.structured.size;
+        return (std::uint64_t(size_high_) << 32) | data_.structured.size;
     }
 
     /// Sets the size of a string, list or dict data type.
     /// Behavior is undefined if the data type is an integer.
-    constexpr void set_size(std::uint32_t v) noexcept
+    constexpr void set_size(std::uint64_t v) noexcept
     {
         Expects(is_string() || is_list() || is_dict());
-        data_.structured.size = v;
+        if (!is_string()) {
+            Expects(v <= std::numeric_limits<std::uint32_t>::max());
+            data_.structured.size = static_cast<std::uint32_t>(v);
+            return;
+        }
+        Expects(v <= max_string_size);
+        data_.structured.size = static_cast<std::uint32_t>(v);
+        size_high_ = static_cast<std::uint8_t>(v >> 32);
+    }
+
+    /// Returns true if the bencoded data of a list or dict is known to be canonical:
+    /// dict keys are strictly increasing in all nested dicts.
+    /// Two canonical values are equal if and only if their bencoded data is equal.
+    /// Behavior is undefined if the data type is not a list or dict.
+    constexpr bool is_canonical() const noexcept
+    {
+        Expects(is_list() || is_dict());
+        return (size_high_ & canonical_flag) != 0;
+    }
+
+    /// Marks the bencoded data of a list or dict as canonical.
+    /// Behavior is undefined if the data type is not a list or dict.
+    constexpr void set_canonical(bool flag = true) noexcept
+    {
+        Expects(is_list() || is_dict());
+        if (flag) size_high_ |= canonical_flag;
+        else size_high_ &= static_cast<std::uint8_t>(~canonical_flag);
     }
 
     /// Returns the offset to matching begin/end token for list/dict,
@@ -225,7 +271,7 @@ public:
     constexpr bool operator==(const descriptor& that) const noexcept
     {
         if (type_ != that.type_) return false;
-        if (position_ != that.position_) return false;
+        if (position() != that.position()) return false;
         if (is_integer()) {
             return value() == that.value();
         } else {
@@ -234,9 +280,19 @@ public:
     }
 
 protected:
+    /// flag in size_high_ of list and dict descriptors, see is_canonical()
+    static constexpr std::uint8_t canonical_flag = 0x01;
+
     descriptor_type type_;
+    /// bits 32-39 of the size of strings, flags of lists and dicts
+    std::uint8_t size_high_;
+    /// bits 32-47 of the position
+    std::uint16_t position_high_;
+    /// bits 0-31 of the position
     std::uint32_t position_;
     descriptor_data data_;
 };
 
+static_assert(sizeof(descriptor) == 16, "wide positions must fit in the padding of descriptor");
+
 }
\ No newline at end of file
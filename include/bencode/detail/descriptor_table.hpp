@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <span>
+#include <vector>
+#include "bencode/detail/byte_hasher.hpp"
 #include "bencode/detail/descriptor.hpp"
+#include "bencode/detail/memory_usage.hpp"
 #include "bencode/detail/bview/bview.hpp"
 #include "bencode/detail/bview/comparison.hpp"
 
@@ -41,7 +46,7 @@ public:
     bview get_root(std::size_t pos = 0) noexcept
     {
         Expects(pos<descriptors_.size());
-        return bview(descriptors_.data()+pos, buffer_+pos);
+        return bview(descriptors_.data()+pos, buffer_);
     }
 
     /// Returns a reference to a std::vector storing the descriptors.
@@ -56,9 +61,108 @@ public:
         return descriptors_;
     }
 
+    /// Compute a hash for every value in the table and store it next to its descriptor.
+    ///
+    /// Hashes are computed bottom-up in a single pass as a Merkle tree:
+    /// integers and strings hash their value, lists and dicts hash the hashes of their elements
+    /// (keys and values for dicts) in stored order. Equal subtrees have equal hashes,
+    /// within the same table or across tables hashed with the same seed.
+    /// The hashes must be recomputed when the descriptors are modified.
+    /// @param seed the seed of the hash function
+    void compute_subtree_hashes(std::uint64_t seed = 0)
+    {
+        auto append = [](detail::byte_hasher& h, std::uint64_t v) {
+            char bytes[sizeof(v)];
+            std::memcpy(bytes, &v, sizeof(v));
+            h.update(std::string_view(bytes, sizeof(v)));
+        };
+
+        hashes_.resize(descriptors_.size());
+        std::vector<detail::byte_hasher> stack {};
+
+        for (std::size_t i = 0; i < descriptors_.size(); ++i) {
+            const auto& d = descriptors_[i];
+            std::uint64_t h;
+
+            // check integers and strings first, the stop flag sets the end bit
+            if (d.is_integer()) {
+                detail::byte_hasher leaf(seed);
+                leaf.update('i');
+                append(leaf, static_cast<std::uint64_t>(d.value()));
+                h = leaf.digest();
+            }
+            else if (d.is_string()) {
+                detail::byte_hasher leaf(seed);
+                leaf.update('s');
+                leaf.update(std::string_view(buffer_ + d.position() + d.offset(), d.size()));
+                h = leaf.digest();
+            }
+            else if (d.is_list_begin() || d.is_dict_begin()) {
+                auto& node = stack.emplace_back(seed);
+                node.update(d.is_list() ? 'l' : 'd');
+                continue;
+            }
+            else {
+                h = stack.back().digest();
+                stack.pop_back();
+                hashes_[i - d.offset()] = h;
+            }
+
+            hashes_[i] = h;
+            if (!stack.empty()) append(stack.back(), h);
+        }
+    }
+
+    /// Returns true if compute_subtree_hashes() was called on a non-empty table.
+    bool has_subtree_hashes() const noexcept
+    { return !hashes_.empty(); }
+
+    /// Returns the hash of the value described by a bview into this table.
+    /// Behavior is undefined if the hashes are not computed or value does not refer to this table.
+    std::uint64_t subtree_hash(const bview& value) const noexcept
+    {
+        const auto pos = static_cast<std::size_t>(detail::get_storage(value) - descriptors_.data());
+        Expects(pos < hashes_.size());
+        return hashes_[pos];
+    }
+
+    /// Returns the hashes computed by compute_subtree_hashes(), one for each descriptor.
+    /// The hash of the end descriptor of a list or dict equals the hash of its begin descriptor.
+    std::span<const std::uint64_t> subtree_hashes() const noexcept
+    { return hashes_; }
+
+    /// Returns the memory used by the descriptor table.
+    /// The bencoded data the table refers to is not included.
+    memory_footprint memory_usage() const noexcept
+    {
+        memory_footprint m {};
+        for (const auto& d : descriptors_) {
+            // the stop flag sets all modifier bits, a real dict key never has the dict_value bit
+            if (d.is_dict_key() && !d.is_dict_value()) continue;
+
+            if (d.is_integer())         ++m.integer_count;
+            else if (d.is_string())     ++m.string_count;
+            else if (d.is_list_begin()) ++m.list_count;
+            else if (d.is_dict_begin()) ++m.dict_count;
+        }
+        m.node_count = m.integer_count + m.string_count + m.list_count + m.dict_count;
+        if (descriptors_.capacity() > 0) {
+            m.heap_bytes = descriptors_.capacity() * sizeof(descriptor);
+            m.allocation_count = 1;
+        }
+        if (hashes_.capacity() > 0) {
+            m.heap_bytes += hashes_.capacity() * sizeof(std::uint64_t);
+            m.allocation_count += 1;
+        }
+        m.total_bytes = sizeof(descriptor_table) + m.heap_bytes;
+        return m;
+    }
+
 private:
     const char* buffer_;
     std::vector<descriptor> descriptors_;
+    /// hashes of the values described by descriptors_, empty when not computed
+    std::vector<std::uint64_t> hashes_ {};
 };
 
 } // namespace bencode
\ No newline at end of file
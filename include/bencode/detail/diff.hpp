@@ -0,0 +1,372 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/bview/bview.hpp"
+#include "bencode/detail/bview/list_bview.hpp"
+#include "bencode/detail/bview/dict_bview.hpp"
+#include "bencode/detail/bview/accessors.hpp"
+#include "bencode/detail/events/encode_to.hpp"
+#include "bencode/detail/decode_view.hpp"
+#include "bencode/detail/encode.hpp"
+#include "bencode/detail/lazy_bvalue.hpp"
+
+/// @file Structural diff and patch of bencoded values.
+
+namespace bencode {
+
+/// Kind of change made by a patch_operation.
+enum class patch_operation_type : char
+{
+    insert  = '+',  ///< add a dict key or insert a list element
+    remove  = '-',  ///< remove a dict key or a list element
+    replace = '=',  ///< replace the value of a dict key or a list element
+};
+
+/// Element of the path of a patch_operation: a dict key or a list index.
+using patch_path_element = std::variant<std::string, std::size_t>;
+
+/// A single change to a bencoded value.
+///
+/// The path locates the changed value from the root, the last element is the key or index
+/// of the changed value in its parent. An empty path refers to the root itself
+/// and is only valid with patch_operation_type::replace.
+/// List indices refer to the value after the preceding operations of the patch are applied.
+struct patch_operation
+{
+    patch_operation_type type;
+    std::vector<patch_path_element> path;
+    /// bencoded representation of the new value, empty for patch_operation_type::remove
+    std::string value;
+
+    bool operator==(const patch_operation&) const = default;
+};
+
+/// Sequence of operations that transforms one bencoded value into another.
+using patch = std::vector<patch_operation>;
+
+
+namespace detail {
+
+inline void emit_patch_operation(patch& out,
+                                 patch_operation_type type,
+                                 const std::vector<patch_path_element>& path,
+                                 patch_path_element last,
+                                 std::string_view value = {})
+{
+    auto& op = out.emplace_back(patch_operation{type, path, std::string(value)});
+    op.path.push_back(std::move(last));
+}
+
+/// Returns true if a and b are canonical and have the same bencoded representation.
+/// This is a single byte comparison and never decodes values.
+inline bool same_canonical(const bview& a, const bview& b) noexcept
+{
+    return a.is_canonical() && b.is_canonical() && a.bencoded_view() == b.bencoded_view();
+}
+
+inline void diff_impl(const bview& a, const bview& b,
+                      std::vector<patch_path_element>& path, patch& out);
+
+inline void diff_dict_impl(const dict_bview& a, const dict_bview& b,
+                           std::vector<patch_path_element>& path, patch& out)
+{
+    auto diff_values = [&](std::string_view key, const bview& va, const bview& vb) {
+        path.emplace_back(std::string(key));
+        diff_impl(va, vb, path, out);
+        path.pop_back();
+    };
+
+    // unsorted keys can only be matched by searching
+    if (!a.has_sorted_keys() || !b.has_sorted_keys()) [[unlikely]] {
+        for (auto it = a.begin(); it != a.end(); ++it) {
+            const auto key = std::string_view(it.key());
+            if (auto match = b.find(key); match != b.end())
+                diff_values(key, it.value(), match.value());
+            else
+                emit_patch_operation(out, patch_operation_type::remove, path, std::string(key));
+        }
+        for (auto it = b.begin(); it != b.end(); ++it) {
+            const auto key = std::string_view(it.key());
+            if (!a.contains(key))
+                emit_patch_operation(out, patch_operation_type::insert, path,
+                                     std::string(key), it.value().bencoded_view());
+        }
+        return;
+    }
+
+    // merge-join the sorted key sequences
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        const auto ka = std::string_view(ia.key());
+        const auto kb = std::string_view(ib.key());
+        if (ka < kb) {
+            emit_patch_operation(out, patch_operation_type::remove, path, std::string(ka));
+            ++ia;
+        }
+        else if (kb < ka) {
+            emit_patch_operation(out, patch_operation_type::insert, path,
+                                 std::string(kb), ib.value().bencoded_view());
+            ++ib;
+        }
+        else {
+            diff_values(ka, ia.value(), ib.value());
+            ++ia;
+            ++ib;
+        }
+    }
+    for (; ia != a.end(); ++ia) {
+        emit_patch_operation(out, patch_operation_type::remove, path, std::string(ia.key()));
+    }
+    for (; ib != b.end(); ++ib) {
+        emit_patch_operation(out, patch_operation_type::insert, path,
+                             std::string(ib.key()), ib.value().bencoded_view());
+    }
+}
+
+inline void diff_list_impl(const list_bview& a, const list_bview& b,
+                           std::vector<patch_path_element>& path, patch& out)
+{
+    auto first_a = a.begin(), last_a = a.end();
+    auto first_b = b.begin(), last_b = b.end();
+
+    // skip the common prefix and suffix of identical canonical elements,
+    // other elements are compared once by the pairwise diff below
+    std::size_t index = 0;
+    for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b, ++index) {
+        if (!same_canonical(bview(*first_a), bview(*first_b))) break;
+    }
+    while (first_a != last_a && first_b != last_b) {
+        const auto prev_a = std::prev(last_a);
+        const auto prev_b = std::prev(last_b);
+        if (!same_canonical(bview(*prev_a), bview(*prev_b))) break;
+        last_a = prev_a;
+        last_b = prev_b;
+    }
+
+    // elements at the same position are compared pairwise,
+    // excess elements are removed from or inserted after the paired range
+    for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b, ++index) {
+        path.emplace_back(index);
+        diff_impl(bview(*first_a), bview(*first_b), path, out);
+        path.pop_back();
+    }
+    for (; first_a != last_a; ++first_a) {
+        emit_patch_operation(out, patch_operation_type::remove, path, index);
+    }
+    for (; first_b != last_b; ++first_b, ++index) {
+        emit_patch_operation(out, patch_operation_type::insert, path,
+                             index, bview(*first_b).bencoded_view());
+    }
+}
+
+inline void diff_impl(const bview& a, const bview& b,
+                      std::vector<patch_path_element>& path, patch& out)
+{
+    // canonical values compare their bencoded representation,
+    // other lists and dicts are compared while recursing and emit no operations when equal
+    if (same_canonical(a, b)) return;
+
+    if (a.type() == b.type()) {
+        if (a.type() == bencode_type::dict) {
+            diff_dict_impl(get_dict(a), get_dict(b), path, out);
+            return;
+        }
+        if (a.type() == bencode_type::list) {
+            diff_list_impl(get_list(a), get_list(b), path, out);
+            return;
+        }
+    }
+    out.push_back(patch_operation{patch_operation_type::replace, path, std::string(b.bencoded_view())});
+}
+
+} // namespace detail
+
+
+/// Returns a patch that transforms a into b.
+///
+/// Dicts are compared by merge-joining their sorted keys in a single linear pass,
+/// and only the values of keys present in both dicts are compared recursively.
+/// Lists are compared after skipping their common prefix and suffix.
+/// Values that compare equal do not generate operations, canonical values are compared
+/// by their bencoded representation without decoding, so every value is compared once.
+/// Inserted and replaced values are copied verbatim from the bencoded data of b.
+/// @param a the original value
+/// @param b the modified value
+/// @returns a patch such that apply_patch(a, diff(a, b)) is equal to b.
+inline patch diff(const bview& a, const bview& b)
+{
+    patch out {};
+    std::vector<patch_path_element> path {};
+    detail::diff_impl(a, b, path, out);
+    return out;
+}
+
+
+/// Apply a patch to a value and return the bencoded representation of the result.
+///
+/// The value is modified through a lazy_bvalue, so subtrees that are not changed
+/// by the patch are copied verbatim from the bencoded data of value.
+/// @param value the value to patch
+/// @param p the patch to apply
+/// @returns the bencoded representation of the patched value
+/// @throw std::out_of_range when a key or index in the path of an operation does not exist
+/// @throw std::invalid_argument when an operation inserts an existing key or removes the root
+/// @throw bad_bvalue_access when the path of an operation does not match the value types
+/// @throw parsing_error when the value of an operation is not valid bencode
+inline std::string apply_patch(const bview& value, const patch& p)
+{
+    // the replacement values are referred to by the lazy value until encoded
+    std::vector<descriptor_table> tables {};
+    tables.reserve(p.size());
+
+    lazy_bvalue root(value);
+
+    for (const auto& op : p) {
+        bview v {};
+        if (op.type != patch_operation_type::remove) {
+            v = tables.emplace_back(decode_view(op.value)).get_root();
+        }
+        if (op.path.empty()) {
+            if (op.type != patch_operation_type::replace)
+                throw std::invalid_argument("patch operation on root value must be replace");
+            root = v;
+            continue;
+        }
+
+        lazy_bvalue* node = &root;
+        for (auto it = op.path.begin(); it != std::prev(op.path.end()); ++it) {
+            node = std::visit([&](const auto& k) -> lazy_bvalue* {
+                if constexpr (std::same_as<std::remove_cvref_t<decltype(k)>, std::string>)
+                    return &node->at(std::string_view(k));
+                else
+                    return &node->at(k);
+            }, *it);
+        }
+
+        if (const auto* key = std::get_if<std::string>(&op.path.back())) {
+            switch (op.type) {
+                case patch_operation_type::insert: {
+                    if (node->contains(*key))
+                        throw std::invalid_argument("patch inserts an existing key");
+                    (*node)[*key] = v;
+                    break;
+                }
+                case patch_operation_type::remove: {
+                    if (node->erase(*key) == 0)
+                        throw std::out_of_range("no item with given key found");
+                    break;
+                }
+                case patch_operation_type::replace: {
+                    node->at(std::string_view(*key)) = v;
+                    break;
+                }
+            }
+        }
+        else {
+            const auto index = std::get<std::size_t>(op.path.back());
+            switch (op.type) {
+                case patch_operation_type::insert:  node->insert(index, v); break;
+                case patch_operation_type::remove:  node->erase(index);     break;
+                case patch_operation_type::replace: node->at(index) = v;    break;
+            }
+        }
+    }
+    return encode(root);
+}
+
+
+/// Returns the bencoded representation of a patch.
+///
+/// A patch is encoded as a list with a list for every operation, holding the operation type
+/// as a single character string ("+", "-" or "="), the path as a list of strings and integers,
+/// and the bencoded value for insert and replace operations.
+/// @param p the patch to encode
+inline std::string encode_patch(const patch& p)
+{
+    std::string s {};
+    auto consumer = events::encode_to(std::back_inserter(s));
+
+    consumer.begin_list(p.size());
+    for (const auto& op : p) {
+        const char type = static_cast<char>(op.type);
+        consumer.begin_list();
+        consumer.string(std::string_view(&type, 1));
+        consumer.list_item();
+        consumer.begin_list(op.path.size());
+        for (const auto& e : op.path) {
+            if (const auto* key = std::get_if<std::string>(&e))
+                consumer.string(*key);
+            else
+                consumer.integer(static_cast<std::int64_t>(std::get<std::size_t>(e)));
+            consumer.list_item();
+        }
+        consumer.end_list(op.path.size());
+        consumer.list_item();
+        if (op.type != patch_operation_type::remove) {
+            consumer.raw(op.value);
+            consumer.list_item();
+        }
+        consumer.end_list();
+        consumer.list_item();
+    }
+    consumer.end_list(p.size());
+    return s;
+}
+
+
+/// Returns the patch described by the output of encode_patch().
+/// @param value a bview to the bencoded representation of a patch
+/// @throw bad_bview_access when the value does not have the structure of an encoded patch
+///        or a path holds a negative list index
+/// @throw std::invalid_argument when an operation type is not valid
+inline patch decode_patch(const bview& value)
+{
+    patch out {};
+    for (const auto& item : get_list(value)) {
+        const auto& op = get_list(item);
+        if (op.empty())
+            throw bad_bview_access("patch operation is empty");
+
+        const bview type_value = op[0];
+        const auto type = std::string_view(get_string(type_value));
+        if (type.size() != 1 || (type[0] != '+' && type[0] != '-' && type[0] != '='))
+            throw std::invalid_argument("invalid patch operation type");
+
+        auto& result = out.emplace_back();
+        result.type = static_cast<patch_operation_type>(type[0]);
+
+        const std::size_t expected_size = result.type == patch_operation_type::remove ? 2 : 3;
+        if (op.size() != expected_size)
+            throw bad_bview_access(fmt::format(
+                    "patch operation '{}' must have {} elements", type, expected_size));
+
+        const bview path = op[1];
+        for (const auto& e : get_list(path)) {
+            if (is_integer(e)) {
+                const auto index = get_integer(e);
+                if (index < 0)
+                    throw bad_bview_access("negative list index in patch path");
+                result.path.emplace_back(static_cast<std::size_t>(index));
+            }
+            else {
+                result.path.emplace_back(std::string(get_string(e)));
+            }
+        }
+        if (result.type != patch_operation_type::remove)
+            result.value = std::string(op[2].bencoded_view());
+    }
+    return out;
+}
+
+} // namespace bencode
@@ -59,6 +59,17 @@ concept event_connecting_is_adl_overloaded =
 } // namespace detail
 
 
+/// The concept `borrowing_event_consumer` is satisfied by event consumers that keep the
+/// string_views passed to string() instead of copying the characters,
+/// e.g. events::to_bvalue with a borrowing policy.
+/// Such a consumer requires every string passed to it to point into the input of the producer.
+/// Producers that pass strings from an internal buffer do not accept borrowing consumers.
+template <typename T>
+concept borrowing_event_consumer = event_consumer<T> && requires {
+    requires T::borrows_strings;
+};
+
+
 // forward declaration
 template <event_consumer EC, typename U, typename T = std::remove_cvref_t<U>>
     requires serializable<T>
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "bencode/detail/json_escape.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+namespace bencode::events {
+
+/// event_consumer that writes CBOR (RFC 8949) to an output iterator.
+///
+/// Strings that are valid UTF-8 are written as text strings, other strings as byte strings.
+/// Lists and dicts are written with definite length when the producer passes the size
+/// to begin_list/begin_dict and with indefinite length otherwise.
+template <typename OIter>
+    requires std::output_iterator<OIter, char>
+class encode_cbor_to
+{
+public:
+    explicit constexpr encode_cbor_to(OIter out) noexcept
+            : out_(out) {}
+
+    encode_cbor_to(const encode_cbor_to&) = delete;
+    encode_cbor_to(encode_cbor_to&&) = delete;
+    encode_cbor_to& operator=(const encode_cbor_to&) = delete;
+    encode_cbor_to& operator=(encode_cbor_to&&) = delete;
+
+    void integer(std::int64_t value)
+    {
+        if (value >= 0)
+            write_head(0, static_cast<std::uint64_t>(value));
+        else
+            write_head(1, ~static_cast<std::uint64_t>(value));
+    }
+
+    void string(std::string_view value)
+    {
+        write_head(detail::is_valid_utf8(value) ? 3 : 2, value.size());
+        out_ = std::copy_n(value.data(), value.size(), out_);
+    }
+
+    void begin_list(std::optional<std::size_t> size = std::nullopt)
+    { begin_container(4, size); }
+
+    void list_item() noexcept {}
+
+    void end_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { end_container(); }
+
+    void begin_dict(std::optional<std::size_t> size = std::nullopt)
+    { begin_container(5, size); }
+
+    void end_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { end_container(); }
+
+    void dict_key() noexcept {}
+
+    void dict_value() noexcept {}
+
+    static void error(const bencode::parsing_error& e)
+    { throw e; }
+
+private:
+    static constexpr char indefinite_length = 31;
+    static constexpr char break_code = static_cast<char>(0xFF);
+
+    void write_head(unsigned major, std::uint64_t argument)
+    {
+        const auto type = static_cast<char>(major << 5);
+        std::size_t n;
+
+        if (argument < 24) {
+            *out_++ = static_cast<char>(type | argument);
+            return;
+        }
+        else if (argument <= 0xFF)       { *out_++ = static_cast<char>(type | 24); n = 1; }
+        else if (argument <= 0xFFFF)     { *out_++ = static_cast<char>(type | 25); n = 2; }
+        else if (argument <= 0xFFFFFFFF) { *out_++ = static_cast<char>(type | 26); n = 4; }
+        else                             { *out_++ = static_cast<char>(type | 27); n = 8; }
+
+        for (std::size_t i = n; i-- > 0; ) {
+            *out_++ = static_cast<char>(argument >> (8 * i));
+        }
+    }
+
+    void begin_container(unsigned major, std::optional<std::size_t> size)
+    {
+        if (size) {
+            write_head(major, *size);
+        }
+        else {
+            *out_++ = static_cast<char>((major << 5) | indefinite_length);
+        }
+        indefinite_.push_back(!size.has_value());
+    }
+
+    void end_container()
+    {
+        if (indefinite_.back()) *out_++ = break_code;
+        indefinite_.pop_back();
+    }
+
+    OIter out_;
+    // true for each open list or dict that is written with indefinite length
+    std::vector<bool> indefinite_ {};
+};
+
+template <typename OutputIterator>
+encode_cbor_to(OutputIterator out) -> encode_cbor_to<OutputIterator>;
+
+encode_cbor_to(std::basic_ostream<char>& os) -> encode_cbor_to<std::ostreambuf_iterator<char>>;
+
+static_assert(event_consumer<encode_cbor_to<char*>>);
+
+} // namespace bencode::events
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "bencode/detail/itoa.hpp"
+#include "bencode/detail/json_escape.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+namespace bencode::events {
+
+/// event_consumer that writes compact JSON to a contiguous character buffer.
+///
+/// Unlike format_json_to this consumer does not insert whitespace and escapes
+/// all characters that are not allowed in JSON strings.
+/// Strings that are not valid UTF-8, e.g. the "pieces" field of a torrent,
+/// are written according to the json_binary_encoding passed at construction.
+/// Output is appended to the given string which can be reused between documents.
+class encode_json_to
+{
+public:
+    explicit encode_json_to(std::string& out,
+                            json_binary_encoding binary = json_binary_encoding::escape) noexcept
+            : out_(out)
+            , binary_(binary)
+    {}
+
+    encode_json_to(const encode_json_to&) = delete;
+    encode_json_to(encode_json_to&&) = delete;
+    encode_json_to& operator=(const encode_json_to&) = delete;
+    encode_json_to& operator=(encode_json_to&&) = delete;
+
+    void integer(std::int64_t value)
+    {
+        separator();
+        const auto n = itoa::to_buffer(buffer_.data(), value);
+        out_.append(buffer_.data(), n);
+    }
+
+    void string(std::string_view value)
+    {
+        separator();
+        write(detail::json_string_max_size(value.size()), [&](char* p) {
+            return detail::write_json_string(p, value, binary_);
+        });
+    }
+
+    void begin_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    {
+        separator();
+        out_.push_back('[');
+    }
+
+    void list_item() noexcept
+    { need_separator_ = true; }
+
+    void end_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { out_.push_back(']'); }
+
+    void begin_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    {
+        separator();
+        out_.push_back('{');
+    }
+
+    void end_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { out_.push_back('}'); }
+
+    void dict_key()
+    {
+        out_.push_back(':');
+        need_separator_ = false;
+    }
+
+    void dict_value() noexcept
+    { need_separator_ = true; }
+
+    static void error(const bencode::parsing_error& e)
+    { throw e; }
+
+private:
+    void separator()
+    {
+        if (need_separator_) out_.push_back(',');
+        need_separator_ = false;
+    }
+
+    /// Grow the buffer by at most max_size characters, let f write to it
+    /// and shrink the buffer to the actually written size.
+    template <typename F>
+    void write(std::size_t max_size, F&& f)
+    {
+        const auto old_size = out_.size();
+#if defined(__cpp_lib_string_resize_and_overwrite)
+        out_.resize_and_overwrite(old_size + max_size, [&](char* p, std::size_t) {
+            return static_cast<std::size_t>(f(p + old_size) - p);
+        });
+#else
+        out_.resize(old_size + max_size);
+        char* p = out_.data();
+        out_.resize(static_cast<std::size_t>(f(p + old_size) - p));
+#endif
+    }
+
+    std::string& out_;
+    json_binary_encoding binary_;
+    bool need_separator_ = false;
+    // buffer for integer to string conversion
+    std::array<char, 20> buffer_ {};
+};
+
+static_assert(event_consumer<encode_json_to>, "internal error");
+
+} // namespace bencode::events
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bencode/detail/json_escape.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+namespace bencode::events {
+
+/// event_consumer that writes MessagePack to a contiguous character buffer.
+///
+/// Strings that are valid UTF-8 are written as str objects, other strings as bin objects.
+/// MessagePack requires the size of arrays and maps in the header. When the producer does
+/// not pass the size to begin_list/begin_dict a 32-bit header is reserved and patched
+/// with the number of items when the list or dict is closed, this is why the output
+/// is appended to a string instead of an output iterator.
+///
+/// MessagePack sizes are limited to 32 bits, larger strings, lists and dicts throw std::length_error.
+class encode_msgpack_to
+{
+public:
+    explicit encode_msgpack_to(std::string& out) noexcept
+            : out_(out)
+    {}
+
+    encode_msgpack_to(const encode_msgpack_to&) = delete;
+    encode_msgpack_to(encode_msgpack_to&&) = delete;
+    encode_msgpack_to& operator=(const encode_msgpack_to&) = delete;
+    encode_msgpack_to& operator=(encode_msgpack_to&&) = delete;
+
+    void integer(std::int64_t value)
+    {
+        if (value >= 0) {
+            const auto v = static_cast<std::uint64_t>(value);
+            if (v <= 0x7F)             out_.push_back(static_cast<char>(v));
+            else if (v <= 0xFF)        write_typed(0xCC, v, 1);
+            else if (v <= 0xFFFF)      write_typed(0xCD, v, 2);
+            else if (v <= 0xFFFFFFFF)  write_typed(0xCE, v, 4);
+            else                       write_typed(0xCF, v, 8);
+        }
+        else {
+            const auto v = static_cast<std::uint64_t>(value);
+            if (value >= -32)          out_.push_back(static_cast<char>(value));
+            else if (value >= INT8_MIN)  write_typed(0xD0, v, 1);
+            else if (value >= INT16_MIN) write_typed(0xD1, v, 2);
+            else if (value >= INT32_MIN) write_typed(0xD2, v, 4);
+            else                         write_typed(0xD3, v, 8);
+        }
+    }
+
+    void string(std::string_view value)
+    {
+        const auto n = value.size();
+        check_size(n, "string");
+        if (detail::is_valid_utf8(value)) {
+            if (n <= 31)          out_.push_back(static_cast<char>(0xA0 | n));
+            else if (n <= 0xFF)   write_typed(0xD9, n, 1);
+            else if (n <= 0xFFFF) write_typed(0xDA, n, 2);
+            else                  write_typed(0xDB, n, 4);
+        }
+        else {
+            if (n <= 0xFF)        write_typed(0xC4, n, 1);
+            else if (n <= 0xFFFF) write_typed(0xC5, n, 2);
+            else                  write_typed(0xC6, n, 4);
+        }
+        out_.append(value);
+    }
+
+    void begin_list(std::optional<std::size_t> size = std::nullopt)
+    { begin_container(0x90, 0xDC, 0xDD, size); }
+
+    void list_item() noexcept
+    { ++frames_.back().count; }
+
+    void end_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { end_container(); }
+
+    void begin_dict(std::optional<std::size_t> size = std::nullopt)
+    { begin_container(0x80, 0xDE, 0xDF, size); }
+
+    void end_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
+    { end_container(); }
+
+    void dict_key() noexcept {}
+
+    void dict_value() noexcept
+    { ++frames_.back().count; }
+
+    static void error(const bencode::parsing_error& e)
+    { throw e; }
+
+private:
+    struct frame
+    {
+        /// offset of the reserved size of the header or std::nullopt if the size was known
+        std::optional<std::size_t> size_offset;
+        std::uint64_t count;
+    };
+
+    static void check_size(std::uint64_t n, const char* what)
+    {
+        if (n > 0xFFFFFFFF) [[unlikely]]
+            throw std::length_error(std::string("msgpack ") + what + " size exceeds 32 bits");
+    }
+
+    void write_typed(unsigned type, std::uint64_t value, std::size_t n)
+    {
+        out_.push_back(static_cast<char>(type));
+        for (std::size_t i = n; i-- > 0; ) {
+            out_.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    void begin_container(unsigned fix_type, unsigned type16, unsigned type32,
+                         std::optional<std::size_t> size)
+    {
+        if (!size) {
+            out_.push_back(static_cast<char>(type32));
+            frames_.push_back({.size_offset = out_.size(), .count = 0});
+            out_.append(4, '\0');
+            return;
+        }
+        check_size(*size, "container");
+        if (*size <= 15)          out_.push_back(static_cast<char>(fix_type | *size));
+        else if (*size <= 0xFFFF) write_typed(type16, *size, 2);
+        else                      write_typed(type32, *size, 4);
+        frames_.push_back({.size_offset = std::nullopt, .count = 0});
+    }
+
+    void end_container()
+    {
+        const auto& f = frames_.back();
+        if (f.size_offset) {
+            check_size(f.count, "container");
+            for (std::size_t i = 0; i < 4; ++i) {
+                out_[*f.size_offset + i] = static_cast<char>(f.count >> (8 * (3 - i)));
+            }
+        }
+        frames_.pop_back();
+    }
+
+    std::string& out_;
+    std::vector<frame> frames_ {};
+};
+
+static_assert(event_consumer<encode_msgpack_to>, "internal error");
+
+} // namespace bencode::events
@@ -48,6 +48,13 @@ public:
         size_ += (n + 1 + value.size());
     }
 
+    /// Write a value that is already bencoded, e.g. the bencoded_view() of a bview.
+    constexpr void raw(std::string_view bencoded) noexcept
+    {
+        out_ = std::copy_n(bencoded.data(), bencoded.size(), out_);
+        size_ += bencoded.size();
+    }
+
     constexpr void begin_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt) noexcept
     {
         *out_++ = symbol::begin_list;
@@ -9,6 +9,7 @@
 #include "bencode/detail/bencode_type.hpp"
 #include "bencode/detail/concepts.hpp"
 #include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/events/sorted_entries.hpp"
 #include "bencode/detail/serialization_traits.hpp"
 
 
@@ -173,21 +174,12 @@ constexpr void connect_events_default_dict_impl(customization_point_type<T>,
         }
     }
     else {
-        // sort keys before serializing
-
-        std::vector<K> keys{};
-        keys.reserve(rng::size(value));
-        std::transform(rng::begin(value), rng::end(value), std::back_inserter(keys),
-                       [](const auto& p) { return p.first; });
-        std::sort(keys.begin(), keys.end());
-
-        for (auto&& key : keys) {
-            auto it = value.find(key);
-
-            connect(consumer, detail::forward_like<K>(it->first));
+        // visit the elements in key order through a sorted array of pointers
+        for (const auto* entry : detail::sorted_entries(value)) {
+            connect(consumer, entry->first);
             consumer.dict_key();
 
-            connect(consumer, detail::forward_like<V>(it->second));
+            connect(consumer, entry->second);
             consumer.dict_value();
         }
     }
@@ -206,7 +198,7 @@ constexpr void connect_events_default_runtime_impl(
 } // namespace detail
 
 /// Process events generated from the producer by an event consumer.
-template <event_consumer EC, typename U, typename T = std::remove_cvref_t<U>>
+template <event_consumer EC, typename U, typename T>
     requires serializable<T>
 constexpr void connect(EC& consumer, U&& producer)
 {
@@ -10,6 +10,7 @@
 #include <bencode/detail/utils.hpp>
 #include <bencode/detail/parser/parsing_error.hpp>
 #include <bencode/detail/itoa.hpp>
+#include <bencode/detail/json_escape.hpp>
 
 namespace bencode::events {
 
@@ -44,9 +45,10 @@ public:
     void string(std::string_view value)
     {
         next();
-        *out_++ = '"';
-        std::copy_n(value.data(), value.size(), out_);
-        *out_++ = '"';
+        string_buffer_.resize(detail::json_string_max_size(value.size()));
+        auto* last = detail::write_json_string(
+                string_buffer_.data(), value, json_binary_encoding::escape);
+        out_ = std::copy(string_buffer_.data(), last, out_);
     }
 
     void begin_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
@@ -131,6 +133,8 @@ private:
     std::array<char, 24> line_buffer_ {};
     std::array<char, 20> int_buffer_ {};
     // buffer for integer to string conversion
+    std::string string_buffer_ {};
+    // buffer for escaped strings
 };
 
 template <typename OutputIterator>
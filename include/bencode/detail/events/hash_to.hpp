@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "bencode/detail/itoa.hpp"
+#include "bencode/detail/symbol.hpp"
+#include "bencode/detail/byte_hasher.hpp"
+#include "bencode/detail/events/concepts.hpp"
+
+namespace bencode::events {
+
+/// event_consumer that hashes the bencoded representation of the events
+/// without writing the encoded data to a buffer.
+/// The result equals the hash of the output of encode_to for the same events.
+class hash_to
+{
+public:
+    explicit constexpr hash_to(std::uint64_t seed = 0) noexcept
+            : hasher_(seed) {}
+
+    constexpr void integer(std::int64_t value) noexcept
+    {
+        buffer_[0] = symbol::begin_integer;
+        const auto n = itoa::to_buffer(buffer_.data() + 1, value);
+        buffer_[n + 1] = symbol::end;
+        hasher_.update(std::string_view(buffer_.data(), n + 2));
+    }
+
+    constexpr void string(std::string_view value) noexcept
+    {
+        const auto n = itoa::to_buffer(buffer_.data(), value.size());
+        buffer_[n] = symbol::colon;
+        hasher_.update(std::string_view(buffer_.data(), n + 1));
+        hasher_.update(value);
+    }
+
+    /// Hash a value that is already bencoded, e.g. the bencoded_view() of a bview.
+    constexpr void raw(std::string_view bencoded) noexcept
+    { hasher_.update(bencoded); }
+
+    constexpr void begin_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt) noexcept
+    { hasher_.update(symbol::begin_list); }
+
+    constexpr void list_item() noexcept { };
+
+    constexpr void end_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt) noexcept
+    { hasher_.update(symbol::end); }
+
+    constexpr void begin_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt) noexcept
+    { hasher_.update(symbol::begin_dict); }
+
+    constexpr void end_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt) noexcept
+    { hasher_.update(symbol::end); }
+
+    constexpr void dict_key() noexcept { };
+
+    constexpr void dict_value() noexcept { };
+
+    /// Returns the hash of the bencoded representation of all events so far.
+    constexpr std::uint64_t value() const noexcept
+    { return hasher_.digest(); }
+
+private:
+    detail::byte_hasher hasher_;
+    // buffer for integer to string conversion and the surrounding tokens
+    std::array<char, 22> buffer_ {};
+};
+
+static_assert(event_consumer<hash_to>);
+
+} // namespace bencode::events
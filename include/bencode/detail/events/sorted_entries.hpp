@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @file Canonical key ordering for dicts with unsorted keys.
+
+namespace bencode::detail {
+
+namespace rng = std::ranges;
+
+/// Entries with fewer elements are sorted with std::sort,
+/// larger ones with a most significant digit radix sort on the key bytes.
+inline constexpr std::size_t radix_sort_threshold = 1024;
+
+/// Subranges smaller than this are sorted by comparison during a radix sort.
+inline constexpr std::size_t radix_sort_cutoff = 64;
+
+/// Subranges still unsorted after this many bucketing passes are sorted by comparison.
+inline constexpr std::size_t radix_sort_max_passes = 64;
+
+/// Sort [first, last) by the bytes of key(*it) starting at depth.
+/// Bytes are compared as unsigned char, the same order as std::string_view comparison.
+/// Subranges are kept on an explicit work stack and the common prefix of a subrange
+/// is skipped before bucketing, so long shared prefixes take neither stack space
+/// nor a pass over the subrange per shared byte.
+template <std::random_access_iterator It, typename Key>
+void msd_radix_sort(It first, It last, std::size_t depth, Key key,
+                    std::vector<std::iter_value_t<It>>& buffer)
+{
+    struct subrange
+    {
+        std::size_t first;
+        std::size_t last;
+        std::size_t depth;
+        std::size_t passes;
+    };
+
+    std::vector<subrange> work {{0, static_cast<std::size_t>(last - first), depth, 0}};
+    std::array<std::size_t, 258> offsets {};
+
+    while (!work.empty()) {
+        const auto [lo, hi, d, passes] = work.back();
+        work.pop_back();
+
+        const auto sub_first = first + static_cast<std::ptrdiff_t>(lo);
+        const auto sub_last = first + static_cast<std::ptrdiff_t>(hi);
+        const auto n = hi - lo;
+
+        if (n < radix_sort_cutoff || passes >= radix_sort_max_passes) {
+            std::sort(sub_first, sub_last, [&](const auto& lhs, const auto& rhs) {
+                return key(lhs).substr(d) < key(rhs).substr(d);
+            });
+            continue;
+        }
+
+        // skip the bytes shared by all keys
+        const std::string_view head = key(*sub_first);
+        std::size_t prefix = head.size();
+        for (auto it = std::next(sub_first); it != sub_last && prefix > d; ++it) {
+            const std::string_view k = key(*it);
+            const auto limit = std::min(prefix, k.size());
+            const auto mismatch = std::mismatch(head.begin() + static_cast<std::ptrdiff_t>(d),
+                                                head.begin() + static_cast<std::ptrdiff_t>(limit),
+                                                k.begin() + static_cast<std::ptrdiff_t>(d));
+            prefix = static_cast<std::size_t>(mismatch.first - head.begin());
+        }
+        const std::size_t at = std::max(prefix, d);
+
+        // bucket 0 holds keys that end before at, bucket b + 1 keys with byte b at at
+        auto bucket = [&](const auto& e) -> std::size_t {
+            const std::string_view k = key(e);
+            return k.size() <= at ? 0 : static_cast<unsigned char>(k[at]) + 1;
+        };
+
+        offsets.fill(0);
+        for (auto it = sub_first; it != sub_last; ++it) ++offsets[bucket(*it) + 1];
+        for (std::size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+
+        buffer.resize(n);
+        auto next = offsets;
+        for (auto it = sub_first; it != sub_last; ++it) buffer[next[bucket(*it)]++] = *it;
+        std::copy(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(n), sub_first);
+
+        for (std::size_t b = 1; b < 257; ++b) {
+            if (offsets[b + 1] - offsets[b] > 1) {
+                work.push_back({lo + offsets[b], lo + offsets[b + 1], at + 1, passes + 1});
+            }
+        }
+    }
+}
+
+/// Returns pointers to the elements of an associative container ordered by key.
+/// Keys are neither copied nor looked up again.
+template <typename T>
+auto sorted_entries(const T& value) -> std::vector<const typename T::value_type*>
+{
+    using entry = const typename T::value_type*;
+    using key_type = typename T::key_type;
+
+    std::vector<entry> entries {};
+    entries.reserve(rng::size(value));
+
+    if constexpr (std::convertible_to<const key_type&, std::string_view>) {
+        // keep a view of the key next to the pointer to avoid an indirection per comparison
+        using keyed_entry = std::pair<std::string_view, entry>;
+        auto key = [](const keyed_entry& e) { return e.first; };
+
+        std::vector<keyed_entry> keyed {};
+        keyed.reserve(rng::size(value));
+        for (const auto& e : value) keyed.emplace_back(e.first, std::addressof(e));
+
+        if (keyed.size() >= radix_sort_threshold) {
+            std::vector<keyed_entry> buffer {};
+            msd_radix_sort(keyed.begin(), keyed.end(), 0, key, buffer);
+        }
+        else {
+            std::sort(keyed.begin(), keyed.end(),
+                      [](const keyed_entry& lhs, const keyed_entry& rhs) { return lhs.first < rhs.first; });
+        }
+        for (const auto& e : keyed) entries.push_back(e.second);
+    }
+    else {
+        for (const auto& e : value) entries.push_back(std::addressof(e));
+        std::sort(entries.begin(), entries.end(),
+                  [](entry lhs, entry rhs) { return lhs->first < rhs->first; });
+    }
+    return entries;
+}
+
+} // namespace bencode::detail
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stack>
+
 #include "bencode/detail/bvalue/bvalue_policy.hpp"
 #include "bencode/detail/bvalue/basic_bvalue.hpp"
 
@@ -14,6 +16,10 @@ public:
     using string_type = typename detail::policy_string_t<Policy>;
     using list_type = typename detail::policy_list_t<Policy>;
     using dict_type = typename detail::policy_dict_t<Policy>;
+    using dict_key_type = typename dict_type::key_type;
+
+    /// Strings are stored as views into the input of the producer for a borrowing policy.
+    static constexpr bool borrows_strings = detail::borrowing_policy<Policy>;
 
     explicit to_bvalue() = default;
 
@@ -24,17 +30,35 @@ public:
     void integer(std::int64_t value)
     { value_.emplace_integer(value); }
 
+    // Strings in dict key position are constructed as dict_key_type directly,
+    // so a policy with a dedicated key type does not allocate a temporary string.
+
     void string(std::string_view value)
-    { value_.emplace_string(value); }
+    {
+        if (expect_key_) keys_.emplace(value);
+        else value_.emplace_string(value);
+    }
 
-    void string(const std::string& value)
-    { value_.emplace_string(value); }
+    void string(const std::string& value) requires (!detail::borrowing_policy<Policy>)
+    {
+        if (expect_key_) keys_.emplace(value);
+        else value_.emplace_string(value);
+    }
+
+    void string(std::string&& value) requires (!detail::borrowing_policy<Policy>)
+    {
+        if (expect_key_) keys_.emplace(std::move(value));
+        else value_.emplace_string(std::move(value));
+    }
 
-    void string(std::string&& value)
-    { value_.emplace_string(std::move(value)); }
+    // A borrowing policy can not hold strings that do not outlive the consumer,
+    // use a producer with a contiguous input buffer, see borrowing_event_consumer.
+    void string(const std::string& value) requires detail::borrowing_policy<Policy> = delete;
+    void string(std::string&& value) requires detail::borrowing_policy<Policy> = delete;
 
     void begin_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
     {
+        expect_key_ = false;
         auto& l = stack_.emplace(bencode::btype::list);
 
         if constexpr (bencode::detail::has_reserve_member<list_type>) {
@@ -52,6 +76,7 @@ public:
 
     void end_list([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
     {
+        expect_key_ = false;
         value_ = std::move(stack_.top());
         stack_.pop();
     };
@@ -59,18 +84,21 @@ public:
     void begin_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
     {
         stack_.push(basic_value_type(btype::dict));
+        expect_key_ = true;
     };
 
     void end_dict([[maybe_unused]] std::optional<std::size_t> size = std::nullopt)
     {
+        expect_key_ = false;
         value_ = std::move(stack_.top());
         stack_.pop();
     };
 
     void dict_key()
     {
-        Expects(is_string(value_));
-        keys_.emplace(get_string(std::move(value_)));
+        Expects(expect_key_);
+        Expects(!keys_.empty());
+        expect_key_ = false;
     };
 
     void dict_value()
@@ -79,6 +107,7 @@ public:
         d.insert_or_assign(std::move(keys_.top()), std::move(value_));
         value_.discard();
         keys_.pop();
+        expect_key_ = true;
     };
 
     [[nodiscard]]
@@ -97,7 +126,9 @@ public:
 private:
     basic_value_type value_;
     std::stack<basic_value_type> stack_;
-    std::stack<string_type> keys_;
+    std::stack<dict_key_type> keys_;
+    /// true when the next string is a dict key
+    bool expect_key_ = false;
 };
 
 } // namespace bencode::events
\ No newline at end of file
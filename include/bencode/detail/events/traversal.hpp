@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/events/concepts.hpp"
+
+/// @file Non-recursive event generation for tree shaped event producers.
+
+namespace bencode::detail {
+
+/// Requirements for the traversal traits of a tree shaped event producer.
+///
+/// node is a cheap handle to a value, e.g. a pointer or a view.
+/// Traits provide the type of a node, the contents of integer and string nodes,
+/// the size of list and dict nodes, and iterators over their elements.
+/// sized_end selects if the size is passed to end_list and end_dict as well.
+/// Nodes of any other type are passed to Traits::connect_leaf(consumer, node)
+/// when the traits provide it and are skipped otherwise.
+template <typename Traits>
+concept traversal_traits = requires(const typename Traits::node& n,
+                                    const typename Traits::list_iterator& li,
+                                    const typename Traits::dict_iterator& di) {
+    { Traits::type(n) } -> std::convertible_to<bencode_type>;
+    Traits::integer(n);
+    Traits::string(n);
+    { Traits::size(n) } -> std::convertible_to<std::size_t>;
+    { Traits::list_begin(n) } -> std::same_as<typename Traits::list_iterator>;
+    { Traits::list_end(n) } -> std::same_as<typename Traits::list_iterator>;
+    { Traits::dict_begin(n) } -> std::same_as<typename Traits::dict_iterator>;
+    { Traits::dict_end(n) } -> std::same_as<typename Traits::dict_iterator>;
+    { Traits::list_item(li) } -> std::convertible_to<typename Traits::node>;
+    Traits::dict_key(di);
+    { Traits::dict_value(di) } -> std::convertible_to<typename Traits::node>;
+    { Traits::sized_end } -> std::convertible_to<bool>;
+};
+
+/// Generate events for the tree rooted at root using an explicit stack instead of recursion.
+/// Nesting depth is only limited by available memory.
+template <traversal_traits Traits, event_consumer EC>
+constexpr void connect_iterative(EC& consumer, const typename Traits::node& root)
+{
+    using node = typename Traits::node;
+    using list_iterator = typename Traits::list_iterator;
+    using dict_iterator = typename Traits::dict_iterator;
+
+    struct frame
+    {
+        bool is_dict;
+        std::size_t size;
+        list_iterator list_it;
+        list_iterator list_last;
+        dict_iterator dict_it;
+        dict_iterator dict_last;
+    };
+
+    std::vector<frame> stack {};
+
+    // emit events for a scalar value or the start of a container,
+    // returns true when a container was opened
+    auto open = [&](const node& n) -> bool {
+        switch (Traits::type(n)) {
+            case bencode_type::integer: {
+                consumer.integer(Traits::integer(n));
+                return false;
+            }
+            case bencode_type::string: {
+                consumer.string(Traits::string(n));
+                return false;
+            }
+            case bencode_type::list: {
+                const std::size_t size = Traits::size(n);
+                consumer.begin_list(size);
+                stack.push_back({false, size, Traits::list_begin(n), Traits::list_end(n), {}, {}});
+                return true;
+            }
+            case bencode_type::dict: {
+                const std::size_t size = Traits::size(n);
+                consumer.begin_dict(size);
+                stack.push_back({true, size, {}, {}, Traits::dict_begin(n), Traits::dict_end(n)});
+                return true;
+            }
+            default: {
+                if constexpr (requires { Traits::connect_leaf(consumer, n); })
+                    Traits::connect_leaf(consumer, n);
+                return false;
+            }
+        }
+    };
+
+    // emit the event that closes an element of the enclosing container
+    auto close_element = [&]() {
+        if (stack.empty()) return;
+        if (stack.back().is_dict) consumer.dict_value();
+        else consumer.list_item();
+    };
+
+    if (!open(root)) return;
+
+    while (!stack.empty()) {
+        auto& f = stack.back();
+
+        if (!f.is_dict) {
+            if (f.list_it == f.list_last) {
+                if constexpr (Traits::sized_end) consumer.end_list(f.size);
+                else consumer.end_list();
+                stack.pop_back();
+                close_element();
+                continue;
+            }
+            const node child = Traits::list_item(f.list_it);
+            ++f.list_it;
+            if (!open(child)) consumer.list_item();
+        }
+        else {
+            if (f.dict_it == f.dict_last) {
+                if constexpr (Traits::sized_end) consumer.end_dict(f.size);
+                else consumer.end_dict();
+                stack.pop_back();
+                close_element();
+                continue;
+            }
+            consumer.string(Traits::dict_key(f.dict_it));
+            consumer.dict_key();
+            const node child = Traits::dict_value(f.dict_it);
+            ++f.dict_it;
+            if (!open(child)) consumer.dict_value();
+        }
+    }
+}
+
+} // namespace bencode::detail
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "bencode/detail/byte_hasher.hpp"
+#include "bencode/detail/bview/bview.hpp"
+#include "bencode/detail/bview/integer_bview.hpp"
+#include "bencode/detail/bview/string_bview.hpp"
+#include "bencode/detail/bview/list_bview.hpp"
+#include "bencode/detail/bview/dict_bview.hpp"
+#include "bencode/detail/bvalue/basic_bvalue.hpp"
+#include "bencode/detail/bvalue/events.hpp"
+#include "bencode/detail/events/events.hpp"
+#include "bencode/detail/events/hash_to.hpp"
+
+/// @file Structural hashing of bview and basic_bvalue.
+
+namespace bencode {
+
+/// Returns a hash of the bencoded representation of a bview.
+/// The bencoded data is hashed as stored in the buffer, without decoding.
+/// Values that compare equal have equal hashes.
+/// A bview and a basic_bvalue describing the same canonical value have equal hashes.
+/// @param value the value to hash
+/// @param seed the seed of the hash function
+template <typename T>
+/// \cond CONCEPTS
+    requires std::derived_from<T, bview>
+/// \endcond
+constexpr std::uint64_t hash(const T& value, std::uint64_t seed = 0) noexcept
+{
+    if (value.type() == bencode_type::uninitialized)
+        return detail::hash_bytes({}, seed);
+    return detail::hash_bytes(value.bencoded_view(), seed);
+}
+
+/// Returns a hash of the bencoded representation of a basic_bvalue.
+/// The encoding is hashed while it is generated and is not stored.
+/// Values that compare equal have equal hashes.
+/// @param value the value to hash
+/// @param seed the seed of the hash function
+template <typename Policy>
+std::uint64_t hash(const basic_bvalue<Policy>& value, std::uint64_t seed = 0)
+{
+    auto consumer = events::hash_to(seed);
+    connect(consumer, value);
+    return consumer.value();
+}
+
+namespace detail {
+
+struct bview_hash
+{
+    template <typename T>
+        requires std::derived_from<T, bview>
+    constexpr std::size_t operator()(const T& value) const noexcept
+    { return static_cast<std::size_t>(bencode::hash(value)); }
+};
+
+} // namespace detail
+
+} // namespace bencode
+
+
+template <>
+struct std::hash<bencode::bview> : bencode::detail::bview_hash {};
+
+template <>
+struct std::hash<bencode::integer_bview> : bencode::detail::bview_hash {};
+
+template <>
+struct std::hash<bencode::string_bview> : bencode::detail::bview_hash {};
+
+template <>
+struct std::hash<bencode::list_bview> : bencode::detail::bview_hash {};
+
+template <>
+struct std::hash<bencode::dict_bview> : bencode::detail::bview_hash {};
+
+template <typename Policy>
+struct std::hash<bencode::basic_bvalue<Policy>>
+{
+    std::size_t operator()(const bencode::basic_bvalue<Policy>& value) const
+    { return static_cast<std::size_t>(bencode::hash(value)); }
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/// @file Helpers to write bencode strings as JSON string literals.
+
+namespace bencode {
+
+/// Enumeration specifying how strings that are not valid UTF-8 are written to JSON.
+enum class json_binary_encoding : std::uint8_t
+{
+    /// Write every byte that is not part of a valid UTF-8 sequence as an \\u00XX escape.
+    escape,
+    /// Write the string as a lowercase hexadecimal string.
+    hex,
+    /// Write the string as a base64 encoded string with padding.
+    base64,
+};
+
+} // namespace bencode
+
+namespace bencode::detail {
+
+inline constexpr std::array<char, 16> hex_digits = {
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+inline constexpr std::string_view base64_alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Returns the number of bytes of the valid UTF-8 sequence starting at first,
+/// or 0 if first does not point to a valid UTF-8 sequence.
+constexpr std::size_t utf8_sequence_length(const unsigned char* first, const unsigned char* last) noexcept
+{
+    const unsigned char c = *first;
+    std::size_t n;
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xBF;
+
+    if (c < 0x80)                   return 1;
+    else if (c >= 0xC2 && c <= 0xDF) n = 2;
+    else if (c == 0xE0)             { n = 3; lo = 0xA0; }
+    else if (c == 0xED)             { n = 3; hi = 0x9F; }
+    else if (c >= 0xE1 && c <= 0xEF) n = 3;
+    else if (c == 0xF0)             { n = 4; lo = 0x90; }
+    else if (c == 0xF4)             { n = 4; hi = 0x8F; }
+    else if (c >= 0xF1 && c <= 0xF3) n = 4;
+    else                            return 0;
+
+    if (static_cast<std::size_t>(last - first) < n) return 0;
+    if (first[1] < lo || first[1] > hi) return 0;
+    for (std::size_t i = 2; i < n; ++i) {
+        if ((first[i] & 0xC0) != 0x80) return 0;
+    }
+    return n;
+}
+
+/// Returns true if the given string is valid UTF-8.
+/// Runs of ASCII characters are skipped 16 bytes at a time when SSE2 is available.
+inline bool is_valid_utf8(std::string_view s) noexcept
+{
+    auto* it = reinterpret_cast<const unsigned char*>(s.data());
+    auto* end = it + s.size();
+
+    while (it != end) {
+#if defined(__SSE2__)
+        while (end - it >= 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            const int mask = _mm_movemask_epi8(v);
+            if (mask != 0) {
+                it += std::countr_zero(static_cast<unsigned>(mask));
+                break;
+            }
+            it += 16;
+        }
+        if (it == end) break;
+#endif
+        auto n = utf8_sequence_length(it, end);
+        if (n == 0) return false;
+        it += n;
+    }
+    return true;
+}
+
+/// Upper bound for the number of characters written by write_json_string.
+/// Escaping is the worst case with 6 output characters per input byte,
+/// hex and base64 encoding never exceed this bound.
+constexpr std::size_t json_string_max_size(std::size_t size) noexcept
+{ return 6 * size + 2; }
+
+/// Write the \\u00XX escape sequence for c to out.
+/// @returns pointer past the last written character
+inline char* write_json_unicode_escape(char* out, unsigned char c) noexcept
+{
+    std::memcpy(out, "\\u00", 4);
+    out[4] = hex_digits[c >> 4];
+    out[5] = hex_digits[c & 0x0F];
+    return out + 6;
+}
+
+/// Write the escape sequence for an ASCII character that must be escaped in a JSON string.
+inline char* write_json_escape(char* out, unsigned char c) noexcept
+{
+    switch (c) {
+    case '"':  std::memcpy(out, "\\\"", 2); return out + 2;
+    case '\\': std::memcpy(out, "\\\\", 2); return out + 2;
+    case '\b': std::memcpy(out, "\\b", 2);  return out + 2;
+    case '\f': std::memcpy(out, "\\f", 2);  return out + 2;
+    case '\n': std::memcpy(out, "\\n", 2);  return out + 2;
+    case '\r': std::memcpy(out, "\\r", 2);  return out + 2;
+    case '\t': std::memcpy(out, "\\t", 2);  return out + 2;
+    default:   return write_json_unicode_escape(out, c);
+    }
+}
+
+constexpr bool json_needs_escape(unsigned char c) noexcept
+{ return c < 0x20 || c == '"' || c == '\\'; }
+
+/// Escape a string that is known to be valid UTF-8.
+/// Characters that do not need escaping are copied in blocks of 16 bytes when SSE2 is available.
+/// @returns pointer past the last written character
+inline char* write_json_escaped_utf8(char* out, std::string_view s) noexcept
+{
+    auto* it = reinterpret_cast<const unsigned char*>(s.data());
+    auto* end = it + s.size();
+
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+
+    while (end - it >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(v, control_max), v);
+        const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                is_control);
+        const int mask = _mm_movemask_epi8(special);
+
+        if (mask == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+            out += 16;
+            it += 16;
+            continue;
+        }
+        const auto n = std::countr_zero(static_cast<unsigned>(mask));
+        std::memcpy(out, it, n);
+        out += n;
+        it += n;
+        out = write_json_escape(out, *it++);
+    }
+#endif
+    for (; it != end; ++it) {
+        if (json_needs_escape(*it)) [[unlikely]]
+            out = write_json_escape(out, *it);
+        else
+            *out++ = static_cast<char>(*it);
+    }
+    return out;
+}
+
+/// Escape a string that is not valid UTF-8.
+/// Bytes that are not part of a valid UTF-8 sequence are written as \\u00XX.
+inline char* write_json_escaped_binary(char* out, std::string_view s) noexcept
+{
+    auto* it = reinterpret_cast<const unsigned char*>(s.data());
+    auto* end = it + s.size();
+
+    while (it != end) {
+        if (*it < 0x80) {
+            if (json_needs_escape(*it)) [[unlikely]]
+                out = write_json_escape(out, *it);
+            else
+                *out++ = static_cast<char>(*it);
+            ++it;
+            continue;
+        }
+        if (auto n = utf8_sequence_length(it, end); n != 0) {
+            std::memcpy(out, it, n);
+            out += n;
+            it += n;
+        }
+        else {
+            out = write_json_unicode_escape(out, *it++);
+        }
+    }
+    return out;
+}
+
+/// Write s as lowercase hexadecimal characters.
+inline char* write_hex(char* out, std::string_view s) noexcept
+{
+    for (unsigned char c : s) {
+        *out++ = hex_digits[c >> 4];
+        *out++ = hex_digits[c & 0x0F];
+    }
+    return out;
+}
+
+/// Write s as base64 with padding.
+inline char* write_base64(char* out, std::string_view s) noexcept
+{
+    auto* it = reinterpret_cast<const unsigned char*>(s.data());
+    auto* end = it + s.size();
+
+    for (; end - it >= 3; it += 3) {
+        const std::uint32_t v = (std::uint32_t(it[0]) << 16) | (std::uint32_t(it[1]) << 8) | it[2];
+        *out++ = base64_alphabet[(v >> 18) & 0x3F];
+        *out++ = base64_alphabet[(v >> 12) & 0x3F];
+        *out++ = base64_alphabet[(v >> 6) & 0x3F];
+        *out++ = base64_alphabet[v & 0x3F];
+    }
+    if (const auto rest = end - it; rest != 0) {
+        std::uint32_t v = std::uint32_t(it[0]) << 16;
+        if (rest == 2) v |= std::uint32_t(it[1]) << 8;
+        *out++ = base64_alphabet[(v >> 18) & 0x3F];
+        *out++ = base64_alphabet[(v >> 12) & 0x3F];
+        *out++ = (rest == 2) ? base64_alphabet[(v >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+    return out;
+}
+
+/// Write s as a quoted JSON string.
+/// Strings that are valid UTF-8 are escaped, other strings are written
+/// according to the binary encoding.
+/// The output buffer must have room for at least json_string_max_size(s.size()) characters.
+/// @returns pointer past the last written character
+inline char* write_json_string(char* out, std::string_view s, json_binary_encoding encoding) noexcept
+{
+    *out++ = '"';
+    if (is_valid_utf8(s)) [[likely]] {
+        out = write_json_escaped_utf8(out, s);
+    }
+    else {
+        switch (encoding) {
+        case json_binary_encoding::hex:    out = write_hex(out, s); break;
+        case json_binary_encoding::base64: out = write_base64(out, s); break;
+        default:                           out = write_json_escaped_binary(out, s); break;
+        }
+    }
+    *out++ = '"';
+    return out;
+}
+
+} // namespace bencode::detail
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "bencode/detail/byte_hasher.hpp"
+
+/// @file Dict keys with precomputed metadata for fast lookups.
+
+namespace bencode {
+
+/// A dict key with its length, hash and first bytes computed ahead of time.
+///
+/// Lookups with a key_literal reject candidate keys with a different length
+/// or a different prefix word before comparing the remaining bytes.
+/// Construct instances at compile time with the _key literal:
+/// @code
+/// using namespace bencode::literals;
+/// auto it = get_dict(torrent).find("announce"_key);
+/// @endcode
+/// The referenced characters must outlive the key_literal.
+class key_literal
+{
+public:
+    constexpr explicit key_literal(std::string_view key) noexcept
+            : key_(key)
+            , prefix_(load_prefix(key))
+            , hash_(detail::hash_bytes(key))
+    {}
+
+    /// Returns the key.
+    constexpr std::string_view view() const noexcept
+    { return key_; }
+
+    constexpr operator std::string_view() const noexcept
+    { return key_; }
+
+    /// Returns the length of the key.
+    constexpr std::size_t size() const noexcept
+    { return key_.size(); }
+
+    /// Returns the hash of the key as computed by bencode::detail::hash_bytes.
+    constexpr std::uint64_t hash() const noexcept
+    { return hash_; }
+
+    /// Returns the first 8 bytes of the key packed in an integer, padded with zeros.
+    constexpr std::uint64_t prefix() const noexcept
+    { return prefix_; }
+
+    /// Returns true if candidate is equal to the key.
+    /// The length and prefix word are compared before the remaining bytes.
+    constexpr bool matches(std::string_view candidate) const noexcept
+    {
+        if (candidate.size() != key_.size()) return false;
+        if (load_prefix(candidate) != prefix_) return false;
+        if (key_.size() <= prefix_size) return true;
+        return std::char_traits<char>::compare(
+                candidate.data() + prefix_size,
+                key_.data() + prefix_size,
+                key_.size() - prefix_size) == 0;
+    }
+
+    constexpr bool operator==(std::string_view candidate) const noexcept
+    { return matches(candidate); }
+
+private:
+    static constexpr std::size_t prefix_size = sizeof(std::uint64_t);
+
+    static constexpr std::uint64_t load_prefix(std::string_view s) noexcept
+    {
+        std::uint64_t v = 0;
+        const std::size_t n = s.size() < prefix_size ? s.size() : prefix_size;
+        for (std::size_t i = 0; i < n; ++i)
+            v |= std::uint64_t(static_cast<unsigned char>(s[i])) << (8 * i);
+        return v;
+    }
+
+    std::string_view key_;
+    std::uint64_t prefix_;
+    std::uint64_t hash_;
+};
+
+} // namespace bencode
+
+
+namespace bencode::literals {
+
+/// Construct a key_literal at compile time.
+consteval bencode::key_literal operator""_key(const char* str, std::size_t size) noexcept
+{ return bencode::key_literal(std::string_view(str, size)); }
+
+}
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gsl/gsl_assert>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/serialization_traits.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/events/traversal.hpp"
+#include "bencode/detail/bview/bview.hpp"
+#include "bencode/detail/bview/list_bview.hpp"
+#include "bencode/detail/bview/dict_bview.hpp"
+#include "bencode/detail/bvalue/basic_bvalue.hpp"
+#include "bencode/detail/bvalue/bad_bvalue_access.hpp"
+
+/// @file Copy-on-write value over a bview.
+
+namespace bencode {
+
+namespace detail {
+template <typename Policy> struct lazy_bvalue_traversal_traits;
+}
+
+/// A value that refers to bencoded data through a bview until it is modified.
+///
+/// Mutating access materializes only the nodes on the path to the modified value:
+/// a materialized list or dict holds its elements as basic_lazy_bvalue instances that still
+/// refer to the bencoded data. Untouched subtrees are encoded by copying their bencoded
+/// representation, so re-encoding a value after a change costs time proportional to the
+/// number of materialized nodes and the size of the output.
+///
+/// The buffer and descriptor table the bview refers to must outlive the value.
+template <typename Policy = default_bvalue_policy>
+class basic_lazy_bvalue
+{
+public:
+    using policy_type = Policy;
+    using value_type  = basic_bvalue<Policy>;
+    using string_type = typename value_type::string_type;
+    using list_type   = std::vector<basic_lazy_bvalue>;
+    using dict_type   = std::map<string_type, basic_lazy_bvalue, std::less<>>;
+
+    /// Construct an uninitialized value.
+    basic_lazy_bvalue() = default;
+
+    /// Construct a value referring to the bencoded data described by view.
+    basic_lazy_bvalue(const bview& view)
+            : storage_(view)
+    {}
+
+    /// Construct a value owning value.
+    basic_lazy_bvalue(value_type value)
+            : storage_(std::move(value))
+    {}
+
+    basic_lazy_bvalue(const basic_lazy_bvalue&) = default;
+    basic_lazy_bvalue(basic_lazy_bvalue&&) noexcept = default;
+    basic_lazy_bvalue& operator=(const basic_lazy_bvalue&) = default;
+    basic_lazy_bvalue& operator=(basic_lazy_bvalue&&) noexcept = default;
+
+    /// Replace the value with a reference to the bencoded data described by view.
+    basic_lazy_bvalue& operator=(const bview& view)
+    {
+        storage_ = view;
+        return *this;
+    }
+
+    /// Replace the value with an owned value constructed from v.
+    template <typename T>
+        requires (!std::same_as<std::remove_cvref_t<T>, basic_lazy_bvalue>) &&
+                 (!std::derived_from<std::remove_cvref_t<T>, bview>) &&
+                 std::constructible_from<value_type, T>
+    basic_lazy_bvalue& operator=(T&& v)
+    {
+        storage_ = value_type(std::forward<T>(v));
+        return *this;
+    }
+
+    /// Returns the bencode type of the value.
+    bencode_type type() const noexcept
+    {
+        switch (storage_.index()) {
+            case view_index:  return std::get<view_index>(storage_).type();
+            case value_index: return std::get<value_index>(storage_).type();
+            case list_index:  return bencode_type::list;
+            case dict_index:  return bencode_type::dict;
+        }
+        BENCODE_UNREACHABLE;
+    }
+
+    /// Returns true if the value still refers to unmodified bencoded data.
+    bool is_view() const noexcept
+    { return storage_.index() == view_index; }
+
+    /// Returns the bview of an unmodified value.
+    /// Behavior is undefined when is_view() is false.
+    const bview& view() const noexcept
+    {
+        Expects(is_view());
+        return std::get<view_index>(storage_);
+    }
+
+    /// Returns the number of elements of a list or dict.
+    /// @throw bad_bvalue_access when the value is not a list or a dict
+    std::size_t size() const
+    {
+        switch (storage_.index()) {
+            case view_index: {
+                const auto& v = std::get<view_index>(storage_);
+                if (is_list(v)) return get_list(v).size();
+                if (is_dict(v)) return get_dict(v).size();
+                break;
+            }
+            case value_index: {
+                const auto& v = std::get<value_index>(storage_);
+                if (is_list(v)) return get_list(v).size();
+                if (is_dict(v)) return get_dict(v).size();
+                break;
+            }
+            case list_index: return std::get<list_index>(storage_).size();
+            case dict_index: return std::get<dict_index>(storage_).size();
+        }
+        throw bad_bvalue_access("bvalue alternative type is not list or dict");
+    }
+
+    /// Returns true if the value is a dict with an element with given key.
+    /// Does not materialize the value.
+    bool contains(std::string_view key) const
+    {
+        switch (storage_.index()) {
+            case view_index: {
+                const auto& v = std::get<view_index>(storage_);
+                return is_dict(v) && get_dict(v).contains(key);
+            }
+            case value_index: {
+                const auto& v = std::get<value_index>(storage_);
+                return is_dict(v) && get_dict(v).find(key) != get_dict(v).end();
+            }
+            case dict_index: {
+                const auto& d = std::get<dict_index>(storage_);
+                return d.find(key) != d.end();
+            }
+            default: return false;
+        }
+    }
+
+    /// Returns a reference to the element with given key, inserting an uninitialized value
+    /// if no such element exists. An uninitialized value becomes an empty dict.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a dict
+    basic_lazy_bvalue& operator[](std::string_view key)
+    {
+        if (type() == bencode_type::uninitialized)
+            storage_.template emplace<dict_index>();
+        auto& d = materialized_dict();
+        if (auto it = d.find(key); it != d.end())
+            return it->second;
+        return d.emplace(string_type(key), basic_lazy_bvalue{}).first->second;
+    }
+
+    /// Returns a reference to the element with given key.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a dict
+    /// @throw std::out_of_range when there is no element with given key
+    basic_lazy_bvalue& at(std::string_view key)
+    {
+        auto& d = materialized_dict();
+        if (auto it = d.find(key); it != d.end())
+            return it->second;
+        throw std::out_of_range("no item with given key found");
+    }
+
+    /// Returns a reference to the element at position pos.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a list
+    /// @throw std::out_of_range when pos is not smaller than size()
+    basic_lazy_bvalue& at(std::size_t pos)
+    {
+        auto& l = materialized_list();
+        if (pos >= l.size())
+            throw std::out_of_range("element index out of range");
+        return l[pos];
+    }
+
+    /// Returns a reference to the element at position pos. No bounds checking is performed.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a list
+    basic_lazy_bvalue& operator[](std::size_t pos)
+    { return materialized_list()[pos]; }
+
+    /// Removes the element with given key from a dict.
+    /// @returns the number of elements removed
+    /// @throw bad_bvalue_access when the value is not a dict
+    std::size_t erase(std::string_view key)
+    {
+        auto& d = materialized_dict();
+        if (auto it = d.find(key); it != d.end()) {
+            d.erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+    /// Removes the element at position pos from a list.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a list
+    /// @throw std::out_of_range when pos is not smaller than size()
+    void erase(std::size_t pos)
+    {
+        auto& l = materialized_list();
+        if (pos >= l.size())
+            throw std::out_of_range("element index out of range");
+        l.erase(std::next(l.begin(), static_cast<std::ptrdiff_t>(pos)));
+    }
+
+    /// Inserts an element before position pos in a list.
+    /// Materializes this value but not its elements.
+    /// @throw bad_bvalue_access when the value is not a list
+    /// @throw std::out_of_range when pos is larger than size()
+    void insert(std::size_t pos, basic_lazy_bvalue value)
+    {
+        auto& l = materialized_list();
+        if (pos > l.size())
+            throw std::out_of_range("element index out of range");
+        l.insert(std::next(l.begin(), static_cast<std::ptrdiff_t>(pos)), std::move(value));
+    }
+
+    /// Appends an element to a list. An uninitialized value becomes a list.
+    /// @throw bad_bvalue_access when the value is not a list
+    void push_back(basic_lazy_bvalue value)
+    {
+        if (type() == bencode_type::uninitialized)
+            storage_.template emplace<list_index>();
+        materialized_list().push_back(std::move(value));
+    }
+
+    /// Returns a basic_bvalue with a copy of the complete value.
+    value_type to_value() const
+    {
+        switch (storage_.index()) {
+            case view_index: return value_type(std::get<view_index>(storage_));
+            case value_index: return std::get<value_index>(storage_);
+            case list_index: {
+                value_type out(btype::list);
+                auto& l = get_list(out);
+                for (const auto& v : std::get<list_index>(storage_))
+                    l.push_back(v.to_value());
+                return out;
+            }
+            case dict_index: {
+                value_type out(btype::dict);
+                auto& d = get_dict(out);
+                for (const auto& [k, v] : std::get<dict_index>(storage_))
+                    d.emplace(k, v.to_value());
+                return out;
+            }
+        }
+        BENCODE_UNREACHABLE;
+    }
+
+    /// Returns the number of materialized list and dict nodes, including this value.
+    std::size_t materialized_count() const
+    {
+        struct counter : detail::discard_consumer
+        {
+            using discard_consumer::begin_list;
+            using discard_consumer::begin_dict;
+            void begin_list(std::size_t) { ++count; }
+            void begin_dict(std::size_t) { ++count; }
+            std::size_t count = 0;
+        };
+
+        // traversal without connect_leaf skips nodes that are not materialized
+        counter c {};
+        detail::connect_iterative<detail::lazy_bvalue_traversal_traits<Policy>>(c, this);
+        return c.count;
+    }
+
+    friend struct detail::lazy_bvalue_traversal_traits<Policy>;
+
+private:
+    static constexpr std::size_t view_index  = 0;
+    static constexpr std::size_t value_index = 1;
+    static constexpr std::size_t list_index  = 2;
+    static constexpr std::size_t dict_index  = 3;
+
+    /// Replace a list by a list_type with an element per item, without materializing the items.
+    list_type& materialized_list()
+    {
+        if (storage_.index() == view_index) {
+            const auto& v = std::get<view_index>(storage_);
+            if (!is_list(v)) [[unlikely]]
+                throw bad_bvalue_access("bvalue alternative type is not list");
+            const auto& bl = get_list(v);
+            list_type l {};
+            l.reserve(bl.size());
+            for (const auto& e : bl) l.emplace_back(e);
+            return storage_.template emplace<list_index>(std::move(l));
+        }
+        if (storage_.index() == value_index) {
+            auto& v = std::get<value_index>(storage_);
+            if (!is_list(v)) [[unlikely]]
+                throw bad_bvalue_access("bvalue alternative type is not list");
+            auto& bl = get_list(v);
+            list_type l {};
+            l.reserve(bl.size());
+            for (auto& e : bl) l.emplace_back(std::move(e));
+            return storage_.template emplace<list_index>(std::move(l));
+        }
+        if (storage_.index() != list_index) [[unlikely]]
+            throw bad_bvalue_access("bvalue alternative type is not list");
+        return std::get<list_index>(storage_);
+    }
+
+    /// Replace a dict by a dict_type with an element per item, without materializing the items.
+    dict_type& materialized_dict()
+    {
+        if (storage_.index() == view_index) {
+            const auto& v = std::get<view_index>(storage_);
+            if (!is_dict(v)) [[unlikely]]
+                throw bad_bvalue_access("bvalue alternative type is not dict");
+            const auto& bd = get_dict(v);
+            dict_type d {};
+            for (auto it = bd.begin(); it != bd.end(); ++it)
+                d.emplace_hint(d.end(), string_type(it.key()), basic_lazy_bvalue(it.value()));
+            return storage_.template emplace<dict_index>(std::move(d));
+        }
+        if (storage_.index() == value_index) {
+            auto& v = std::get<value_index>(storage_);
+            if (!is_dict(v)) [[unlikely]]
+                throw bad_bvalue_access("bvalue alternative type is not dict");
+            dict_type d {};
+            for (auto& [k, e] : get_dict(v))
+                d.emplace_hint(d.end(), k, basic_lazy_bvalue(std::move(e)));
+            return storage_.template emplace<dict_index>(std::move(d));
+        }
+        if (storage_.index() != dict_index) [[unlikely]]
+            throw bad_bvalue_access("bvalue alternative type is not dict");
+        return std::get<dict_index>(storage_);
+    }
+
+    std::variant<bview, value_type, list_type, dict_type> storage_ {std::in_place_index<value_index>};
+};
+
+using lazy_bvalue = basic_lazy_bvalue<default_bvalue_policy>;
+
+
+template <typename Policy>
+struct serialization_traits<basic_lazy_bvalue<Policy>> : serializes_to_runtime_type {};
+
+
+namespace detail {
+
+/// Traversal traits for the materialized lists and dicts of a basic_lazy_bvalue,
+/// nodes are pointers to values.
+/// Values that are not materialized have type uninitialized.
+template <typename Policy>
+struct lazy_bvalue_traversal_traits
+{
+    using lazy = basic_lazy_bvalue<Policy>;
+    using node = const lazy*;
+    using list_iterator = typename lazy::list_type::const_iterator;
+    using dict_iterator = typename lazy::dict_type::const_iterator;
+    static constexpr bool sized_end = true;
+
+    static constexpr bencode_type type(node n) noexcept
+    {
+        switch (n->storage_.index()) {
+            case lazy::list_index: return bencode_type::list;
+            case lazy::dict_index: return bencode_type::dict;
+            default:               return bencode_type::uninitialized;
+        }
+    }
+    static constexpr std::int64_t integer(node) noexcept { return 0; }
+    static constexpr std::string_view string(node) noexcept { return {}; }
+    static constexpr std::size_t size(node n)
+    { return type(n) == bencode_type::list ? list(n).size() : dict(n).size(); }
+
+    static constexpr list_iterator list_begin(node n) { return list(n).begin(); }
+    static constexpr list_iterator list_end(node n) { return list(n).end(); }
+    static constexpr dict_iterator dict_begin(node n) { return dict(n).begin(); }
+    static constexpr dict_iterator dict_end(node n) { return dict(n).end(); }
+
+    static constexpr node list_item(const list_iterator& it) { return std::addressof(*it); }
+    static constexpr std::string_view dict_key(const dict_iterator& it) { return it->first; }
+    static constexpr node dict_value(const dict_iterator& it) { return std::addressof(it->second); }
+
+    static const bview* view(node n) { return std::get_if<lazy::view_index>(&n->storage_); }
+    static const auto* value(node n) { return std::get_if<lazy::value_index>(&n->storage_); }
+
+private:
+    static const auto& list(node n) { return std::get<lazy::list_index>(n->storage_); }
+    static const auto& dict(node n) { return std::get<lazy::dict_index>(n->storage_); }
+};
+
+/// Traversal traits for basic_lazy_bvalue that pass values that are not materialized
+/// to consumers with a raw(std::string_view) member function as their bencoded representation.
+template <typename Policy>
+struct lazy_bvalue_connect_traits : lazy_bvalue_traversal_traits<Policy>
+{
+    using base = lazy_bvalue_traversal_traits<Policy>;
+
+    template <event_consumer EC>
+    static void connect_leaf(EC& consumer, typename base::node n)
+    {
+        if (const auto* v = base::view(n)) {
+            if constexpr (requires { consumer.raw(std::string_view{}); })
+                consumer.raw(v->bencoded_view());
+            else
+                connect(consumer, *v);
+        }
+        else if (const auto* v = base::value(n)) {
+            connect(consumer, *v);
+        }
+    }
+};
+
+} // namespace detail
+
+/// Generate events for a basic_lazy_bvalue.
+/// Unmodified subtrees are passed to consumers with a raw(std::string_view) member function,
+/// such as events::encode_to, as their bencoded representation.
+template <typename Policy, event_consumer EC>
+void bencode_connect(customization_point_type<basic_lazy_bvalue<Policy>>,
+                     EC& consumer, const basic_lazy_bvalue<Policy>& value)
+{
+    detail::connect_iterative<detail::lazy_bvalue_connect_traits<Policy>>(
+            consumer, std::addressof(value));
+}
+
+} // namespace bencode
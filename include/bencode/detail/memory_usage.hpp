@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// @file Memory footprint accounting for decoded data.
+
+namespace bencode {
+
+/// Memory used by a decoded bencode value.
+///
+/// Node counts include every integer, string, list and dict value.
+/// Dict keys are not counted as nodes but their storage is included in the byte counts.
+struct memory_footprint
+{
+    /// Size of the object itself plus heap_bytes.
+    std::size_t total_bytes = 0;
+    /// Bytes of heap memory owned directly or indirectly by the object.
+    std::size_t heap_bytes = 0;
+    /// Number of heap blocks owned directly or indirectly by the object.
+    std::size_t allocation_count = 0;
+    std::size_t node_count = 0;
+    std::size_t integer_count = 0;
+    std::size_t string_count = 0;
+    std::size_t list_count = 0;
+    std::size_t dict_count = 0;
+};
+
+namespace detail {
+
+/// Per element overhead of the nodes of a node based container such as std::map or std::list:
+/// the red-black tree node header with three pointers and the color field.
+inline constexpr std::size_t container_node_overhead = 4 * sizeof(void*);
+
+/// Add the heap memory owned by a string.
+/// Strings that fit in the small string buffer do not allocate.
+template <typename String>
+void add_string_heap_usage(memory_footprint& m, const String& s) noexcept
+{
+    using value_type = typename String::value_type;
+
+    if constexpr (requires { s.capacity(); }) {
+        static const std::size_t inline_capacity = String().capacity();
+        if (s.capacity() > inline_capacity) {
+            m.heap_bytes += (s.capacity() + 1) * sizeof(value_type);
+            ++m.allocation_count;
+        }
+    }
+}
+
+/// Add the heap memory owned by a sequence container, excluding memory owned by its elements.
+/// Containers with a capacity are assumed to use a single contiguous block,
+/// other containers one node per element.
+template <typename List>
+void add_list_heap_usage(memory_footprint& m, const List& l) noexcept
+{
+    using value_type = typename List::value_type;
+
+    if constexpr (requires { l.capacity(); }) {
+        if (l.capacity() > 0) {
+            m.heap_bytes += l.capacity() * sizeof(value_type);
+            ++m.allocation_count;
+        }
+    }
+    else {
+        m.heap_bytes += l.size() * (sizeof(value_type) + container_node_overhead);
+        m.allocation_count += l.size();
+    }
+}
+
+/// Add the heap memory owned by an associative container, excluding memory owned by its elements.
+/// Associative containers are assumed to allocate one node per element.
+template <typename Dict>
+void add_dict_heap_usage(memory_footprint& m, const Dict& d) noexcept
+{
+    using value_type = typename Dict::value_type;
+
+    m.heap_bytes += d.size() * (sizeof(value_type) + container_node_overhead);
+    m.allocation_count += d.size();
+}
+
+} // namespace detail
+
+} // namespace bencode
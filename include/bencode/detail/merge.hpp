@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/symbol.hpp"
+#include "bencode/detail/bview/bview.hpp"
+#include "bencode/detail/bview/string_bview.hpp"
+#include "bencode/detail/bview/list_bview.hpp"
+#include "bencode/detail/bview/dict_bview.hpp"
+#include "bencode/detail/bview/accessors.hpp"
+
+/// @file Merging bencoded dicts without decoding.
+
+namespace bencode {
+
+/// Selects the value kept for a key present in both dicts passed to merge().
+enum class merge_conflict_policy : char
+{
+    overlay_wins,   ///< keep the value of the overlay dict
+    base_wins,      ///< keep the value of the base dict
+    error,          ///< throw merge_conflict_error
+};
+
+/// Options for merge().
+struct merge_options
+{
+    /// Merge the values of a key present in both dicts when both values are dicts,
+    /// instead of applying the conflict policy.
+    bool recursive = true;
+    /// Value kept for a key present in both dicts with different values.
+    merge_conflict_policy conflict = merge_conflict_policy::overlay_wins;
+};
+
+/// Error thrown by merge() for conflicting values with merge_conflict_policy::error.
+class merge_conflict_error : public std::runtime_error
+{
+public:
+    explicit merge_conflict_error(std::string_view key)
+            : std::runtime_error("conflicting values for key: " + std::string(key))
+            , key_(key)
+    {}
+
+    /// Returns the key with conflicting values.
+    const std::string& key() const noexcept
+    { return key_; }
+
+private:
+    std::string key_;
+};
+
+
+namespace detail {
+
+using dict_bview_entries = std::vector<std::pair<string_bview, bview>>;
+
+/// Returns the entries of a dict with unsorted keys sorted by key.
+/// Of entries with duplicate keys the first one is kept.
+inline dict_bview_entries sorted_dict_bview_entries(const dict_bview& d)
+{
+    dict_bview_entries entries {};
+    for (auto it = d.begin(); it != d.end(); ++it) {
+        entries.emplace_back(it.key(), it.value());
+    }
+    auto key_less = [](const auto& l, const auto& r) {
+        return std::string_view(l.first) < std::string_view(r.first);
+    };
+    auto key_equal = [](const auto& l, const auto& r) {
+        return std::string_view(l.first) == std::string_view(r.first);
+    };
+    std::stable_sort(entries.begin(), entries.end(), key_less);
+    entries.erase(std::unique(entries.begin(), entries.end(), key_equal), entries.end());
+    return entries;
+}
+
+inline void write_canonical(const bview& value, std::string& out);
+
+template <typename Range>
+inline void write_canonical_dict_entries(const Range& entries, std::string& out)
+{
+    out.push_back(symbol::begin_dict);
+    for (const auto& [k, v] : entries) {
+        out.append(k.bencoded_view());
+        write_canonical(v, out);
+    }
+    out.push_back(symbol::end);
+}
+
+/// Append the canonical bencoded representation of value to out.
+/// Canonical values are copied verbatim, this includes all integers and strings
+/// since the parser rejects leading zeros.
+inline void write_canonical(const bview& value, std::string& out)
+{
+    if (value.is_canonical()) {
+        out.append(value.bencoded_view());
+        return;
+    }
+    if (value.type() == bencode_type::list) {
+        out.push_back(symbol::begin_list);
+        for (const auto& e : get_list(value)) {
+            write_canonical(e, out);
+        }
+        out.push_back(symbol::end);
+        return;
+    }
+    if (value.type() == bencode_type::dict) {
+        const auto& d = get_dict(value);
+        if (d.has_sorted_keys())
+            write_canonical_dict_entries(d, out);
+        else
+            write_canonical_dict_entries(sorted_dict_bview_entries(d), out);
+        return;
+    }
+    out.append(value.bencoded_view());
+}
+
+inline void merge_impl(const dict_bview& base, const dict_bview& overlay,
+                       const merge_options& options, std::string& out);
+
+/// Merge-join two ranges of dict entries sorted by key.
+template <typename BaseRange, typename OverlayRange>
+inline void merge_join(const BaseRange& base, const OverlayRange& overlay,
+                       const merge_options& options, std::string& out)
+{
+    auto write_entry = [&](const string_bview& key, const bview& value) {
+        out.append(key.bencoded_view());
+        write_canonical(value, out);
+    };
+
+    out.push_back(symbol::begin_dict);
+
+    auto ia = std::begin(base);
+    auto ib = std::begin(overlay);
+    while (ia != std::end(base) && ib != std::end(overlay)) {
+        const auto& [key_a, value_a] = *ia;
+        const auto& [key_b, value_b] = *ib;
+        const auto ka = std::string_view(key_a);
+        const auto kb = std::string_view(key_b);
+
+        if (ka < kb) {
+            write_entry(key_a, value_a);
+            ++ia;
+            continue;
+        }
+        if (kb < ka) {
+            write_entry(key_b, value_b);
+            ++ib;
+            continue;
+        }
+
+        if (options.recursive && is_dict(value_a) && is_dict(value_b)) {
+            out.append(key_a.bencoded_view());
+            merge_impl(get_dict(value_a), get_dict(value_b), options, out);
+        }
+        else {
+            // equal values only need to be compared when a conflict is an error
+            switch (options.conflict) {
+                case merge_conflict_policy::overlay_wins: write_entry(key_b, value_b); break;
+                case merge_conflict_policy::base_wins:    write_entry(key_a, value_a); break;
+                case merge_conflict_policy::error: {
+                    if (value_a != value_b) throw merge_conflict_error(ka);
+                    write_entry(key_a, value_a);
+                    break;
+                }
+            }
+        }
+        ++ia;
+        ++ib;
+    }
+    for (; ia != std::end(base); ++ia) {
+        const auto& [key, value] = *ia;
+        write_entry(key, value);
+    }
+    for (; ib != std::end(overlay); ++ib) {
+        const auto& [key, value] = *ib;
+        write_entry(key, value);
+    }
+
+    out.push_back(symbol::end);
+}
+
+inline void merge_impl(const dict_bview& base, const dict_bview& overlay,
+                       const merge_options& options, std::string& out)
+{
+    const bool base_sorted = base.has_sorted_keys();
+    const bool overlay_sorted = overlay.has_sorted_keys();
+
+    // dicts with sorted keys are joined in place, others are sorted first
+    if (base_sorted && overlay_sorted) [[likely]]
+        merge_join(base, overlay, options, out);
+    else if (base_sorted)
+        merge_join(base, sorted_dict_bview_entries(overlay), options, out);
+    else if (overlay_sorted)
+        merge_join(sorted_dict_bview_entries(base), overlay, options, out);
+    else
+        merge_join(sorted_dict_bview_entries(base), sorted_dict_bview_entries(overlay), options, out);
+}
+
+} // namespace detail
+
+
+/// Merge two dicts and return the bencoded representation of the result.
+///
+/// The sorted key sequences of both dicts are merge-joined in a single linear pass
+/// and the bencoded representation of keys and values is copied verbatim,
+/// without decoding the values. Keys present in only one dict keep their value.
+/// For keys present in both dicts, nested dicts are merged when options.recursive is set,
+/// other values are selected by options.conflict unless they compare equal.
+/// The result is canonical: values with unsorted dict keys are re-encoded in sorted order.
+/// @param base the dict to merge into
+/// @param overlay the dict with values that override those of base
+/// @param options selects recursive merging and the conflict policy
+/// @returns the bencoded representation of the merged dict
+/// @throw merge_conflict_error when values conflict and options.conflict is merge_conflict_policy::error
+inline std::string merge(const dict_bview& base,
+                         const dict_bview& overlay,
+                         const merge_options& options = {})
+{
+    std::string out {};
+    out.reserve(base.bencoded_view().size() + overlay.bencoded_view().size());
+    detail::merge_impl(base, overlay, options, out);
+    return out;
+}
+
+} // namespace bencode
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/bview/bad_bview_access.hpp"
+#include "bencode/detail/parser/reader.hpp"
+
+namespace bencode {
+
+/// A value in a bencoded buffer that is decoded on demand.
+///
+/// An ondemand_value is a position of a value in a buffer. Accessing a dict member
+/// or list element reads the buffer from that position and skips over preceding siblings
+/// using string length prefixes, without building a descriptor table.
+/// Only the bytes on the access path are read, which makes this cheaper than
+/// descriptor_parser for a few lookups in a freshly received buffer.
+/// Repeated lookups in the same value scan the buffer again, use descriptor_parser and
+/// bview when many values are accessed.
+///
+/// Malformed data is detected when it is read and reported by throwing parsing_error.
+class ondemand_value
+{
+public:
+    /// Construct a value at offset pos of a bencoded buffer.
+    ondemand_value(std::string_view data, std::size_t pos, const parser_options& options = {}) noexcept
+            : data_(data)
+            , pos_(pos)
+            , options_(options)
+    {}
+
+    /// Returns the type of the value.
+    /// @throws parsing_error if the value does not start with a valid token.
+    bencode_type type() const
+    {
+        switch (make_reader().next()) {
+        case reader_token::integer:    return btype::integer;
+        case reader_token::string:     return btype::string;
+        case reader_token::begin_list: return btype::list;
+        case reader_token::begin_dict: return btype::dict;
+        default: throw parsing_error(parsing_errc::unexpected_eof, pos_);
+        }
+    }
+
+    bool is_integer() const { return type() == btype::integer; }
+    bool is_string() const  { return type() == btype::string; }
+    bool is_list() const    { return type() == btype::list; }
+    bool is_dict() const    { return type() == btype::dict; }
+
+    /// Returns the value of an integer.
+    /// @throws bad_bview_access if the value is not an integer.
+    std::int64_t as_integer() const
+    {
+        check_type(btype::integer);
+        return make_reader().read_integer();
+    }
+
+    /// Returns a view to the contents of a string in the buffer.
+    /// @throws bad_bview_access if the value is not a string.
+    std::string_view as_string() const
+    {
+        check_type(btype::string);
+        return make_reader().read_string();
+    }
+
+    /// Returns the dict member with given key or std::nullopt if no such member exists.
+    /// @throws bad_bview_access if the value is not a dict.
+    std::optional<ondemand_value> find(std::string_view key) const
+    {
+        check_type(btype::dict);
+        auto r = make_reader();
+        r.enter_dict();
+        while (r.next() != reader_token::end) {
+            if (r.read_string() == key) return child(r);
+            r.skip_value();
+        }
+        return std::nullopt;
+    }
+
+    /// Returns true if the dict has a member with given key.
+    /// @throws bad_bview_access if the value is not a dict.
+    bool contains(std::string_view key) const
+    { return find(key).has_value(); }
+
+    /// Returns the dict member with given key.
+    /// @throws bad_bview_access if the value is not a dict.
+    /// @throws std::out_of_range if no member with given key exists.
+    ondemand_value at(std::string_view key) const
+    {
+        if (auto v = find(key)) return *v;
+        throw std::out_of_range("no item with given key found");
+    }
+
+    /// Returns the list element at pos.
+    /// @throws bad_bview_access if the value is not a list.
+    /// @throws std::out_of_range if pos is not smaller than the size of the list.
+    ondemand_value at(std::size_t pos) const
+    {
+        check_type(btype::list);
+        auto r = make_reader();
+        r.enter_list();
+        for (std::size_t i = 0; r.next() != reader_token::end; ++i) {
+            if (i == pos) return child(r);
+            r.skip_value();
+        }
+        throw std::out_of_range("element index out of range");
+    }
+
+    /// @copydoc at(std::string_view) const
+    ondemand_value operator[](std::string_view key) const
+    { return at(key); }
+
+    /// @copydoc at(std::size_t) const
+    /// Accepts any integral type so that a literal 0 does not convert to a null key pointer.
+    template <std::integral T>
+    ondemand_value operator[](T pos) const
+    { return at(static_cast<std::size_t>(pos)); }
+
+    /// Overload for string literals, which would otherwise be ambiguous with the list index.
+    ondemand_value operator[](const char* key) const
+    { return at(std::string_view(key)); }
+
+    /// Returns the number of elements of a list or members of a dict.
+    /// This reads the complete list or dict.
+    std::size_t size() const
+    {
+        auto r = make_reader();
+        const auto t = type();
+        if (t != btype::list && t != btype::dict) [[unlikely]]
+            throw bad_bview_access("bvalue is not of type: list or dict");
+
+        t == btype::list ? r.enter_list() : r.enter_dict();
+        std::size_t n = 0;
+        for (; r.next() != reader_token::end; ++n) {
+            if (t == btype::dict) r.read_string();
+            r.skip_value();
+        }
+        return n;
+    }
+
+    /// Returns the bencoded representation of the value.
+    std::string_view raw() const
+    {
+        auto r = make_reader();
+        r.skip_value();
+        return data_.substr(pos_, r.position() - pos_);
+    }
+
+private:
+    reader make_reader() const noexcept
+    { return reader(data_, pos_, options_); }
+
+    ondemand_value child(const reader& r) const noexcept
+    { return ondemand_value(data_, r.position(), options_); }
+
+    void check_type(bencode_type expected) const
+    {
+        if (type() != expected) [[unlikely]]
+            throw bad_bview_access(fmt::format("bvalue is not of type: {}", to_string(expected)));
+    }
+
+    std::string_view data_;
+    std::size_t pos_;
+    parser_options options_;
+};
+
+
+/// A bencoded document that is decoded on demand.
+/// @see ondemand_value
+class ondemand_document
+{
+public:
+    explicit ondemand_document(std::string_view data, const parser_options& options = {}) noexcept
+            : root_(data, 0, options)
+    {}
+
+    /// Returns the root value of the document.
+    ondemand_value root() const noexcept
+    { return root_; }
+
+    ondemand_value operator[](std::string_view key) const
+    { return root_[key]; }
+
+    ondemand_value operator[](const char* key) const
+    { return root_[key]; }
+
+    template <std::integral T>
+    ondemand_value operator[](T pos) const
+    { return root_[pos]; }
+
+private:
+    ondemand_value root_;
+};
+
+} // namespace bencode
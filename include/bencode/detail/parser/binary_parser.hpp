@@ -0,0 +1,469 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gsl/gsl_assert>
+#include <nonstd/expected.hpp>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/parser/common.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+/// @file Shared code between parsers for binary serialization formats.
+
+namespace bencode::detail {
+
+/// Kind of a data item read by a binary format reader.
+enum class binary_item_kind : std::uint8_t
+{
+    integer,
+    string,
+    list,
+    dict,
+    /// end of a container with indefinite length
+    end,
+};
+
+/// A data item header read by a binary format reader.
+/// Strings are read completely, for lists and dicts only the header is read.
+struct binary_item
+{
+    binary_item_kind kind;
+    std::int64_t integer = 0;
+    std::string_view string {};
+    /// number of list items or dict members, std::nullopt for indefinite length
+    std::optional<std::size_t> size = std::nullopt;
+};
+
+/// Read an unsigned big endian integer of n bytes.
+template <std::size_t N>
+constexpr std::uint64_t load_big_endian(const char* p) noexcept
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        value = (value << 8) | static_cast<unsigned char>(p[i]);
+    }
+    return value;
+}
+
+/// A binary format reader reads one data item header from a byte sequence.
+/// Readers set strings_point_into_input when every string they read refers to the input,
+/// and never to the buffer.
+template <typename T>
+concept binary_format_reader = requires(const char*& it, const char* end, std::string& buffer) {
+    { T::read(it, end, buffer) } -> std::same_as<nonstd::expected<binary_item, parsing_errc>>;
+    { T::invalid_item } -> std::convertible_to<parsing_errc>;
+    { T::strings_point_into_input } -> std::convertible_to<bool>;
+};
+
+enum class binary_token_type : std::uint8_t
+{
+    integer,
+    string,
+    /// string that was assembled from chunks, stored in the parser
+    buffered_string,
+    list,
+    dict,
+};
+
+/// An event recorded while parsing a data item, before it is passed to a consumer.
+struct binary_token
+{
+    binary_token_type type;
+    /// string: length, list and dict: number of elements
+    std::size_t size;
+    /// integer: value, string: offset in the input or in the buffered string storage,
+    /// dict: offset of its members in the sorted member index
+    std::int64_t value;
+    /// list and dict: index one past the last token of the value
+    std::size_t end;
+};
+
+/// A member of a dict that is not closed yet.
+struct binary_dict_member
+{
+    /// index of the token of the key
+    std::size_t key;
+    /// offset of the key in the input
+    std::size_t position;
+};
+
+struct binary_parser_stack_frame
+{
+    bool is_dict;
+    /// index of the token of the list or dict
+    std::size_t token;
+    /// remaining items or members, std::nullopt for indefinite length
+    std::optional<std::size_t> remaining;
+    /// dict: index of the first member in the pending member list
+    std::size_t first_member;
+};
+
+/// A list or dict of which events are being passed to a consumer.
+struct binary_emit_frame
+{
+    bool is_dict;
+    /// list: index of the next token, dict: index of the next member in the sorted member index
+    std::size_t next;
+    std::size_t last;
+    std::size_t size;
+};
+
+/// Parser for binary serialization formats that generates events.
+///
+/// The format specific decoding of data item headers is done by the Format reader.
+/// Bencode requires dict keys to be sorted. Each top-level data item is parsed in a single pass
+/// into a buffer of events. When a dict is closed its members are sorted by key,
+/// and once the data item is complete the events are passed to the consumer in sorted key order.
+/// Every input byte is read once and every buffered event is replayed once.
+/// Strings are not copied unless they were assembled from chunks, the event buffers are reused
+/// between data items. Duplicate keys are rejected.
+template <binary_format_reader Format>
+class binary_parser
+{
+    using token = binary_token;
+    using token_type = binary_token_type;
+    using member = binary_dict_member;
+    using stack_frame = binary_parser_stack_frame;
+    using emit_frame = binary_emit_frame;
+
+public:
+    using options = parser_options;
+
+    explicit binary_parser(const options& options = {})
+            : options_(options)
+    {}
+
+    /// Parse a string_view and pass generated events to the event consumer.
+    /// Concatenated data items are parsed as successive values.
+    /// The events of a data item are passed to the consumer after the complete item is parsed.
+    /// Consumers that keep the string_views they receive are only accepted when
+    /// the format never passes strings from an internal buffer.
+    /// @returns true if successful, false if an error occurred.
+    template <event_consumer EC>
+        requires (Format::strings_point_into_input || !borrowing_event_consumer<EC>)
+    bool parse(EC& consumer, std::string_view s)
+    {
+        begin_ = s.data();
+        it_ = s.data();
+        end_ = s.data() + s.size();
+        error_ = std::nullopt;
+        stack_.clear();
+        reset_value();
+        value_count_ = 0;
+
+        while (!has_error()) {
+            if (stack_.empty()) {
+                if (it_ == end_) break;
+                auto item = read_item();
+                if (!item) [[unlikely]] break;
+                handle_item(consumer, *item);
+            }
+            else if (stack_.back().is_dict) {
+                handle_dict_member(consumer);
+            }
+            else {
+                handle_list_item(consumer);
+            }
+        }
+        return !has_error();
+    }
+
+    bool has_error() const noexcept
+    { return error_.has_value(); }
+
+    parsing_error error() const
+    {
+        Expects(error_.has_value());
+        return *error_;
+    }
+
+private:
+    std::optional<binary_item> read_item()
+    {
+        const char* start = it_;
+        auto item = Format::read(it_, end_, string_buffer_);
+        if (!item) [[unlikely]] {
+            it_ = start;
+            set_error(item.error());
+            return std::nullopt;
+        }
+        return *item;
+    }
+
+    template <event_consumer EC>
+    void handle_item(EC& consumer, const binary_item& item)
+    {
+        if (++value_count_ > options_.value_limit) [[unlikely]] {
+            set_error(parsing_errc::value_limit_exceeded);
+            return;
+        }
+
+        switch (item.kind) {
+        case binary_item_kind::integer:
+            tokens_.push_back({.type = token_type::integer, .size = 0, .value = item.integer, .end = 0});
+            handle_value_end(consumer);
+            return;
+        case binary_item_kind::string:
+            push_string(item.string);
+            handle_value_end(consumer);
+            return;
+        case binary_item_kind::list:
+        case binary_item_kind::dict: {
+            if (stack_.size() >= options_.recursion_limit) [[unlikely]] {
+                set_error(parsing_errc::recursion_depth_exceeded);
+                return;
+            }
+            const bool is_dict = item.kind == binary_item_kind::dict;
+            stack_.push_back({.is_dict = is_dict, .token = tokens_.size(),
+                              .remaining = item.size, .first_member = members_.size()});
+            tokens_.push_back({.type = is_dict ? token_type::dict : token_type::list,
+                               .size = 0, .value = 0, .end = 0});
+            return;
+        }
+        default:
+            set_error(Format::invalid_item);
+        }
+    }
+
+    /// Count a completed value in its parent, or pass the events of a completed
+    /// top-level data item to the consumer.
+    template <event_consumer EC>
+    void handle_value_end(EC& consumer)
+    {
+        if (stack_.empty()) {
+            emit(consumer);
+            reset_value();
+            return;
+        }
+        if (!stack_.back().is_dict) {
+            ++tokens_[stack_.back().token].size;
+        }
+    }
+
+    template <event_consumer EC>
+    void handle_list_item(EC& consumer)
+    {
+        auto& frame = stack_.back();
+
+        if (frame.remaining == 0) {
+            tokens_[frame.token].end = tokens_.size();
+            stack_.pop_back();
+            handle_value_end(consumer);
+            return;
+        }
+        auto item = read_item();
+        if (!item) [[unlikely]] return;
+
+        if (item->kind == binary_item_kind::end) {
+            if (frame.remaining.has_value()) [[unlikely]] {
+                set_error(Format::invalid_item, btype::list);
+                return;
+            }
+            frame.remaining = 0;
+            return;
+        }
+        if (frame.remaining) --*frame.remaining;
+        handle_item(consumer, *item);
+    }
+
+    template <event_consumer EC>
+    void handle_dict_member(EC& consumer)
+    {
+        auto& frame = stack_.back();
+
+        if (frame.remaining == 0) {
+            if (!close_dict()) [[unlikely]] return;
+            handle_value_end(consumer);
+            return;
+        }
+
+        const auto position = static_cast<std::size_t>(it_ - begin_);
+        auto key = read_item();
+        if (!key) [[unlikely]] return;
+
+        if (key->kind == binary_item_kind::end && !frame.remaining) {
+            frame.remaining = 0;
+            return;
+        }
+        if (key->kind != binary_item_kind::string) [[unlikely]] {
+            set_error(parsing_errc::expected_string_dict_key, btype::dict);
+            return;
+        }
+        members_.push_back({.key = tokens_.size(), .position = position});
+        push_string(key->string);
+
+        auto value = read_item();
+        if (!value) [[unlikely]] return;
+        if (value->kind == binary_item_kind::end) [[unlikely]] {
+            set_error(Format::invalid_item, btype::dict);
+            return;
+        }
+        if (frame.remaining) --*frame.remaining;
+        handle_item(consumer, *value);
+    }
+
+    /// Sort the members of the innermost dict by key and record the order in the sorted member index.
+    bool close_dict()
+    {
+        const auto frame = stack_.back();
+        const auto first = std::next(members_.begin(), static_cast<std::ptrdiff_t>(frame.first_member));
+        const auto last = members_.end();
+
+        const auto key_less = [this](const member& lhs, const member& rhs)
+        { return string_value(tokens_[lhs.key]) < string_value(tokens_[rhs.key]); };
+        const auto key_equal = [this](const member& lhs, const member& rhs)
+        { return string_value(tokens_[lhs.key]) == string_value(tokens_[rhs.key]); };
+
+        if (!std::is_sorted(first, last, key_less)) {
+            std::sort(first, last, key_less);
+        }
+        if (auto dup = std::adjacent_find(first, last, key_equal); dup != last) [[unlikely]] {
+            it_ = begin_ + std::next(dup)->position;
+            set_error(parsing_errc::duplicate_dict_key, btype::dict);
+            return false;
+        }
+
+        auto& t = tokens_[frame.token];
+        t.size = static_cast<std::size_t>(last - first);
+        t.value = static_cast<std::int64_t>(sorted_members_.size());
+        t.end = tokens_.size();
+        for (auto it = first; it != last; ++it) {
+            sorted_members_.push_back(it->key);
+        }
+        members_.erase(first, last);
+        stack_.pop_back();
+        return true;
+    }
+
+    /// Record a string as a token.
+    /// Strings that were assembled from chunks are copied to the buffered string storage.
+    void push_string(std::string_view s)
+    {
+        if (!s.empty() && s.data() == string_buffer_.data()) {
+            tokens_.push_back({.type = token_type::buffered_string, .size = s.size(),
+                               .value = static_cast<std::int64_t>(buffered_strings_.size()), .end = 0});
+            buffered_strings_.append(s);
+        }
+        else {
+            const auto offset = s.empty() ? 0 : s.data() - begin_;
+            tokens_.push_back({.type = token_type::string, .size = s.size(),
+                               .value = static_cast<std::int64_t>(offset), .end = 0});
+        }
+    }
+
+    std::string_view string_value(const token& t) const noexcept
+    {
+        const char* base = t.type == token_type::string ? begin_ : buffered_strings_.data();
+        return std::string_view(base + t.value, t.size);
+    }
+
+    /// Pass the recorded events of a completed top-level data item to the consumer,
+    /// with the members of dicts in sorted key order.
+    template <event_consumer EC>
+    void emit(EC& consumer)
+    {
+        emit_stack_.clear();
+
+        // emit events for a scalar value or the start of a container,
+        // returns true when a container was opened
+        auto open = [&](std::size_t i) -> bool {
+            const auto& t = tokens_[i];
+            switch (t.type) {
+            case token_type::integer:
+                consumer.integer(t.value);
+                return false;
+            case token_type::string:
+            case token_type::buffered_string:
+                consumer.string(string_value(t));
+                return false;
+            case token_type::list:
+                consumer.begin_list(t.size);
+                emit_stack_.push_back({.is_dict = false, .next = i + 1, .last = t.end, .size = t.size});
+                return true;
+            case token_type::dict: {
+                const auto first = static_cast<std::size_t>(t.value);
+                consumer.begin_dict(t.size);
+                emit_stack_.push_back({.is_dict = true, .next = first, .last = first + t.size, .size = t.size});
+                return true;
+            }
+            }
+            return false;
+        };
+
+        // emit the event that closes an element of the enclosing container
+        auto close_element = [&]() {
+            if (emit_stack_.empty()) return;
+            if (emit_stack_.back().is_dict) consumer.dict_value();
+            else consumer.list_item();
+        };
+
+        if (!open(0)) return;
+
+        while (!emit_stack_.empty()) {
+            auto& f = emit_stack_.back();
+            if (f.next == f.last) {
+                if (f.is_dict) consumer.end_dict(f.size);
+                else consumer.end_list(f.size);
+                emit_stack_.pop_back();
+                close_element();
+                continue;
+            }
+
+            std::size_t i;
+            if (f.is_dict) {
+                const auto key = sorted_members_[f.next++];
+                consumer.string(string_value(tokens_[key]));
+                consumer.dict_key();
+                i = key + 1;
+            }
+            else {
+                i = f.next;
+                const auto& t = tokens_[i];
+                f.next = (t.type == token_type::list || t.type == token_type::dict) ? t.end : i + 1;
+            }
+            if (!open(i)) close_element();
+        }
+    }
+
+    /// Clear the event buffers, keeping their capacity.
+    void reset_value() noexcept
+    {
+        tokens_.clear();
+        members_.clear();
+        sorted_members_.clear();
+        buffered_strings_.clear();
+    }
+
+    void set_error(parsing_errc ec, std::optional<bencode_type> context = std::nullopt) noexcept
+    {
+        error_.emplace(ec, static_cast<std::size_t>(it_ - begin_), context);
+    }
+
+    const char* begin_ = nullptr;
+    const char* it_ = nullptr;
+    const char* end_ = nullptr;
+    std::vector<stack_frame> stack_ {};
+    /// events of the current top-level data item
+    std::vector<token> tokens_ {};
+    /// members of dicts that are not closed yet
+    std::vector<member> members_ {};
+    /// key token indices of closed dicts in sorted order
+    std::vector<std::size_t> sorted_members_ {};
+    /// strings of the current top-level data item that were assembled from chunks
+    std::string buffered_strings_ {};
+    std::vector<emit_frame> emit_stack_ {};
+    /// storage for the string read last when it was assembled from chunks
+    std::string string_buffer_ {};
+    std::optional<parsing_error> error_;
+    std::uint32_t value_count_ = 0;
+    options options_;
+};
+
+} // namespace bencode::detail
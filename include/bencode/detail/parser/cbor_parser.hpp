@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <nonstd/expected.hpp>
+
+#include "bencode/detail/parser/binary_parser.hpp"
+
+namespace bencode {
+
+namespace detail {
+
+/// Reader for CBOR (RFC 8949) data item headers.
+struct cbor_format
+{
+    static constexpr parsing_errc invalid_item = parsing_errc::invalid_cbor_item;
+    /// indefinite length strings are concatenated in the buffer
+    static constexpr bool strings_point_into_input = false;
+
+    static nonstd::expected<binary_item, parsing_errc>
+    read(const char*& it, const char* end, std::string& buffer)
+    {
+        using nonstd::make_unexpected;
+
+        while (true) {
+            if (it == end) [[unlikely]]
+                return make_unexpected(parsing_errc::unexpected_eof);
+
+            const auto initial = static_cast<unsigned char>(*it++);
+            const unsigned major = initial >> 5;
+            const unsigned info = initial & 0x1F;
+
+            if (info == 31) {
+                switch (major) {
+                case 2:
+                case 3:
+                    return read_chunked_string(it, end, major, buffer);
+                case 4:
+                    return binary_item{.kind = binary_item_kind::list};
+                case 5:
+                    return binary_item{.kind = binary_item_kind::dict};
+                case 7:
+                    return binary_item{.kind = binary_item_kind::end};
+                default:
+                    return make_unexpected(parsing_errc::invalid_cbor_item);
+                }
+            }
+            auto arg = read_argument(it, end, info);
+            if (!arg) [[unlikely]] return make_unexpected(arg.error());
+
+            switch (major) {
+            case 0:
+                if (*arg > std::uint64_t(std::numeric_limits<std::int64_t>::max())) [[unlikely]]
+                    return make_unexpected(parsing_errc::integer_overflow);
+                return binary_item{.kind = binary_item_kind::integer,
+                                   .integer = static_cast<std::int64_t>(*arg)};
+            case 1:
+                if (*arg > std::uint64_t(std::numeric_limits<std::int64_t>::max())) [[unlikely]]
+                    return make_unexpected(parsing_errc::integer_overflow);
+                return binary_item{.kind = binary_item_kind::integer,
+                                   .integer = -1 - static_cast<std::int64_t>(*arg)};
+            case 2:
+            case 3:
+                if (*arg > std::uint64_t(end - it)) [[unlikely]]
+                    return make_unexpected(parsing_errc::unexpected_eof);
+                it += *arg;
+                return binary_item{.kind = binary_item_kind::string,
+                                   .string = std::string_view(it - *arg, *arg)};
+            case 4:
+                // every item takes at least one byte
+                if (*arg > std::uint64_t(end - it)) [[unlikely]]
+                    return make_unexpected(parsing_errc::unexpected_eof);
+                return binary_item{.kind = binary_item_kind::list, .size = *arg};
+            case 5:
+                if (*arg > std::uint64_t(end - it) / 2) [[unlikely]]
+                    return make_unexpected(parsing_errc::unexpected_eof);
+                return binary_item{.kind = binary_item_kind::dict, .size = *arg};
+            case 6:
+                // tags only add semantics to the tagged item, which is read instead
+                continue;
+            default:
+                if (info == 20 || info == 21) {
+                    return binary_item{.kind = binary_item_kind::integer,
+                                       .integer = info == 21 ? 1 : 0};
+                }
+                return make_unexpected(parsing_errc::unsupported_cbor_value);
+            }
+        }
+    }
+
+private:
+    static nonstd::expected<std::uint64_t, parsing_errc>
+    read_argument(const char*& it, const char* end, unsigned info) noexcept
+    {
+        if (info < 24) return info;
+        if (info > 27) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::invalid_cbor_item);
+
+        const auto n = std::size_t(1) << (info - 24);
+        if (std::size_t(end - it) < n) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+
+        std::uint64_t value;
+        switch (n) {
+        case 1:  value = load_big_endian<1>(it); break;
+        case 2:  value = load_big_endian<2>(it); break;
+        case 4:  value = load_big_endian<4>(it); break;
+        default: value = load_big_endian<8>(it); break;
+        }
+        it += n;
+        return value;
+    }
+
+    /// Concatenate the chunks of an indefinite length string into buffer.
+    static nonstd::expected<binary_item, parsing_errc>
+    read_chunked_string(const char*& it, const char* end, unsigned major, std::string& buffer)
+    {
+        buffer.clear();
+        while (true) {
+            if (it == end) [[unlikely]]
+                return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+
+            const auto initial = static_cast<unsigned char>(*it++);
+            if (initial == 0xFF) break;
+            // chunks must be definite length strings of the same major type
+            if ((initial >> 5) != major || (initial & 0x1F) == 31) [[unlikely]]
+                return nonstd::make_unexpected(parsing_errc::invalid_cbor_item);
+
+            auto n = read_argument(it, end, initial & 0x1F);
+            if (!n) [[unlikely]] return nonstd::make_unexpected(n.error());
+            if (*n > std::uint64_t(end - it)) [[unlikely]]
+                return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+            buffer.append(it, *n);
+            it += *n;
+        }
+        return binary_item{.kind = binary_item_kind::string, .string = std::string_view(buffer)};
+    }
+};
+
+} // namespace detail
+
+/// Parse CBOR and pass generated events to an event consumer.
+///
+/// Byte strings and text strings are both passed as strings.
+/// false and true are passed as the integers 0 and 1, tags are ignored.
+/// null, undefined, floating point numbers and integers that do not fit
+/// in a std::int64_t are rejected.
+/// Dict keys must be strings and are passed to the consumer in sorted order.
+using cbor_parser = detail::binary_parser<detail::cbor_format>;
+
+} // namespace bencode
@@ -90,7 +90,8 @@ parse_integer(It& begin, It end) noexcept
         }
     }
 
-    if (leading_zero && value != 0) [[unlikely]] {
+    // a zero must be the only digit, so every accepted token has a single representation
+    if (leading_zero && (value != 0 || digits > 1)) [[unlikely]] {
         return nonstd::make_unexpected(parsing_errc::leading_zero);
     }
 
@@ -234,7 +235,7 @@ bdecode_string(It&& begin, It end) noexcept
 struct bdecode_string_token_result
 {
     std::uint32_t offset;
-    std::uint32_t size;
+    std::uint64_t size;
 };
 
 
@@ -264,11 +265,9 @@ bdecode_string_token(It& begin , It end) noexcept
     }
     ++it;
 
-    Ensures(size <= std::numeric_limits<std::uint32_t>::max());
-
     const auto prefix_length = static_cast<std::uint32_t>(std::distance(begin, it));
 
-    if (std::next(it, size) > end) [[unlikely]] {
+    if (size > static_cast<std::size_t>(std::distance(it, end))) [[unlikely]] {
         return nonstd::make_unexpected(parsing_errc::unexpected_eof);
     }
     std::advance(it, size);
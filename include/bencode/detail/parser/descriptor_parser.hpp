@@ -13,6 +13,7 @@
 #include "bencode/detail/utils.hpp"
 
 #include "bencode/detail/parser/common.hpp"
+#include "bencode/detail/parser/instrumentation.hpp"
 #include "bencode/detail/parser/parsing_error.hpp"
 
 #include "bencode/detail/descriptor.hpp"
@@ -29,6 +30,10 @@ struct descriptor_parser_stack_frame
     detail::parser_state state;
     std::uint32_t position;
     std::uint32_t size;
+    /// false when keys out of order were found in this value or in a nested value
+    bool canonical = true;
+    /// index of the descriptor of the previous dict key, 0 if there is none
+    std::uint32_t last_key = 0;
 };
 
 constexpr descriptor_type descriptor_type_modifier(parser_state s) noexcept
@@ -48,7 +53,9 @@ constexpr descriptor_type descriptor_type_modifier(parser_state s) noexcept
 }
 
 /// Parse bencoded data into a descriptor_table.
-template <typename Iterator = const char*, typename Sentinel = Iterator>
+/// @tparam Instrumentation policy receiving parser metrics, see stats_instrumentation.
+template <typename Iterator = const char*, typename Sentinel = Iterator,
+          parser_instrumentation Instrumentation = no_instrumentation>
 class descriptor_parser
 {
     using state = detail::parser_state;
@@ -72,21 +79,20 @@ public:
              std::convertible_to<rng::range_value_t<R>, char>
     std::optional<descriptor_table> parse(const R& range) noexcept
     {
-        begin_ = rng::data(range);
-        it_ = rng::data(range);
-        end_ = std::next(rng::data(range), rng::size(range));
-        descriptors_.clear();
-        error_ = std::nullopt;
-
-        auto success = parse_loop();
-
-        if (!success) {
-            Expects(error_);
-            return std::nullopt;
-        }
+        if (!parse_range(range)) return std::nullopt;
         return descriptor_table(std::move(descriptors_), rng::data(range));
     }
 
+    /// Parse like parse() but keep the internal descriptor buffer for the next call
+    /// and copy the descriptors to an exactly sized descriptor_table.
+    /// This avoids regrowing the descriptor buffer when many documents are parsed
+    /// with the same parser.
+    std::optional<descriptor_table> parse_reusing_buffer(std::string_view s) noexcept
+    {
+        if (!parse_range(s)) return std::nullopt;
+        return descriptor_table(std::span<descriptor>(descriptors_), s.data());
+    }
+
     bool has_error() noexcept
     { return error_.has_value(); }
 
@@ -95,7 +101,43 @@ public:
         return *error_;
     }
 
+    /// Returns the instrumentation policy instance.
+    const Instrumentation& instrumentation() const noexcept
+    { return instrumentation_; }
+
+    Instrumentation& instrumentation() noexcept
+    { return instrumentation_; }
+
 private:
+    template <typename R>
+    bool parse_range(const R& range) noexcept
+    {
+        begin_ = rng::data(range);
+        it_ = rng::data(range);
+        end_ = std::next(rng::data(range), rng::size(range));
+        descriptors_.clear();
+        error_ = std::nullopt;
+        // discard the parse context left behind by a previous failed parse
+        if (!stack_.empty()) stack_ = {};
+
+        instrumentation_.on_parse_begin();
+        bool success;
+        // string sizes are stored with 40 bits in a descriptor
+        if (rng::size(range) > descriptor::max_string_size) [[unlikely]] {
+            set_error(parsing_errc::value_limit_exceeded);
+            success = false;
+        }
+        else {
+            success = parse_loop();
+        }
+        instrumentation_.on_parse_end(current_position(), error_);
+
+        if (!success) {
+            Expects(error_);
+        }
+        return success;
+    }
+
     bool parse_loop() noexcept
     {
         // aliases for brevity
@@ -117,9 +159,7 @@ private:
 
             // check current parsing context
             if (!stack_.empty()) {
-                auto [context, position, size] = stack_.top();
-
-                switch (context) {
+                switch (stack_.top().state) {
                 case state::expect_dict_key: {
                     if (c == symbol::digit) [[likely]] {
                         handle_dict_key();
@@ -172,6 +212,9 @@ private:
             if (stack_.top().state == detail::parser_state::expect_list_value) {
                 set_error(parsing_errc::expected_list_value_or_end);
             }
+            if (stack_.top().state == detail::parser_state::expect_dict_value) {
+                set_error(parsing_errc::expected_dict_value, btype::dict);
+            }
             return false;
         }
 
@@ -198,6 +241,7 @@ private:
             return false;
         }
         t.set_value(*result);
+        instrumentation_.on_integer();
         return true;
     }
 
@@ -217,6 +261,7 @@ private:
         auto& t = descriptors_.emplace_back(type, position);
         t.set_offset(result->offset);
         t.set_size(result->size);
+        instrumentation_.on_string(result->size);
         return true;
     }
 
@@ -232,13 +277,12 @@ private:
             if (!success) [[unlikely]] return false;
 
             if constexpr (ParserState == state::expect_dict_value) {
-                auto& [st, start, size] = stack_.top();
-                st = state::expect_dict_key;
-                ++size;
+                auto& frame = stack_.top();
+                frame.state = state::expect_dict_key;
+                ++frame.size;
             }
             else if constexpr (ParserState == state::expect_list_value) {
-                auto& [st, start, size] = stack_.top();
-                ++size;
+                ++stack_.top().size;
             }
             return true;
         };
@@ -287,6 +331,7 @@ private:
                 .position = static_cast<std::uint32_t>(descriptors_.size()-1),
                 .size = 0
         });
+        instrumentation_.on_begin_list(stack_.size());
 
         ++it_;
         return true;
@@ -310,6 +355,7 @@ private:
                 .position = static_cast<std::uint32_t>(descriptors_.size()-1),
                 .size = 0
         });
+        instrumentation_.on_begin_dict(stack_.size());
 
         ++it_;
         return true;
@@ -321,21 +367,24 @@ private:
         Expects(stack_.top().state == state::expect_list_value);
 
         auto type = (descriptor_type::list | descriptor_type::end);
-        const auto[state, start_pos, size] = stack_.top();
+        const auto frame = stack_.top();
+        const auto start_pos = frame.position;
         const auto offset = descriptors_.size() - start_pos;
         const auto position = current_position();
 
         stack_.pop();
         ++it_;
+        if (!frame.canonical && !stack_.empty()) stack_.top().canonical = false;
 
         if (auto s = handle_nested_structures(); s)
             type |= detail::descriptor_type_modifier(*s);
 
         auto& t = descriptors_.emplace_back(type, position);
         descriptors_[start_pos].set_offset(offset);
-        descriptors_[start_pos].set_size(size);
+        descriptors_[start_pos].set_size(frame.size);
+        descriptors_[start_pos].set_canonical(frame.canonical);
         t.set_offset(offset);
-        t.set_size(size);
+        t.set_size(frame.size);
         return true;
     }
 
@@ -345,20 +394,24 @@ private:
         Expects(stack_.top().state == state::expect_dict_key);
 
         auto type = (descriptor_type::dict | descriptor_type::end);
-        const auto& [state, start_pos, size] = stack_.top();
+        const auto frame = stack_.top();
+        const auto start_pos = frame.position;
         const auto offset = descriptors_.size() - start_pos;
         const auto position = current_position();
 
         stack_.pop();
         ++it_;
+        if (!frame.canonical && !stack_.empty()) stack_.top().canonical = false;
+
         if (auto s = handle_nested_structures(); s)
             type |= detail::descriptor_type_modifier(*s);
 
         auto& t = descriptors_.emplace_back(type, position);
         descriptors_[start_pos].set_offset(offset);
-        descriptors_[start_pos].set_size(size);
+        descriptors_[start_pos].set_size(frame.size);
+        descriptors_[start_pos].set_canonical(frame.canonical);
         t.set_offset(offset);
-        t.set_size(size);
+        t.set_size(frame.size);
         return true;
     }
 
@@ -378,11 +431,19 @@ private:
             return false;
         }
 
-        stack_.top().state = state::expect_dict_value;
+        auto& frame = stack_.top();
+        frame.state = state::expect_dict_value;
 
         auto& t = descriptors_.emplace_back(type, position);
         t.set_offset(result->offset);
         t.set_size(result->size);
+
+        // keys of canonical dicts are strictly increasing
+        if (frame.canonical && frame.last_key != 0) {
+            if (!(key_view(descriptors_[frame.last_key]) < key_view(t))) frame.canonical = false;
+        }
+        frame.last_key = static_cast<std::uint32_t>(descriptors_.size() - 1);
+        instrumentation_.on_string(result->size);
         return true;
     }
 
@@ -390,16 +451,23 @@ private:
     {
         if (stack_.empty()) return std::nullopt;
 
-        auto&[state, position, size] = stack_.top();
-        const auto old_state = state;
-        ++size;
+        auto& frame = stack_.top();
+        const auto old_state = frame.state;
+        ++frame.size;
 
-        if (state == state::expect_dict_value) {
-            state = state::expect_dict_key;
+        if (frame.state == state::expect_dict_value) {
+            frame.state = state::expect_dict_key;
         }
         return old_state;
     }
 
+    /// Returns the characters of the string described by a key descriptor.
+    inline std::string_view key_view(const descriptor& d) const noexcept
+    {
+        return {std::next(begin_, static_cast<std::ptrdiff_t>(d.position() + d.offset())),
+                static_cast<std::size_t>(d.size())};
+    }
+
     inline std::size_t current_position() noexcept
     { return (it_ - begin_); }
 
@@ -416,6 +484,7 @@ private:
     std::stack<stack_frame> stack_{};
     std::optional<parsing_error> error_;
     options options_;
+    [[no_unique_address]] Instrumentation instrumentation_ {};
 };
 
 }
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+
+#include "bencode/detail/parser/parsing_error.hpp"
+
+/// @file Instrumentation policies for push_parser and descriptor_parser.
+
+namespace bencode {
+
+/// Requirements for the instrumentation policy of a parser.
+/// The parser calls the hooks for every token it reads successfully
+/// and once at the start and end of every call to parse.
+template <typename T>
+concept parser_instrumentation = requires(T t, std::size_t n, const std::optional<parsing_error>& e) {
+    { T::enabled } -> std::convertible_to<bool>;
+    t.on_parse_begin();
+    t.on_parse_end(n, e);
+    t.on_integer();
+    t.on_string(n);
+    t.on_begin_list(n);
+    t.on_begin_dict(n);
+};
+
+/// Instrumentation policy that does nothing.
+/// All hooks are empty and the policy takes no space in the parser.
+struct no_instrumentation
+{
+    static constexpr bool enabled = false;
+
+    constexpr void on_parse_begin() const noexcept {}
+    constexpr void on_parse_end(std::size_t, const std::optional<parsing_error>&) const noexcept {}
+    constexpr void on_integer() const noexcept {}
+    constexpr void on_string(std::size_t) const noexcept {}
+    constexpr void on_begin_list(std::size_t) const noexcept {}
+    constexpr void on_begin_dict(std::size_t) const noexcept {}
+};
+
+/// Counters collected by stats_instrumentation.
+/// Counters accumulate over all parse calls until reset.
+struct parser_stats
+{
+    /// Number of calls to parse.
+    std::size_t parse_count = 0;
+    /// Number of input bytes read, up to the error position for failed parses.
+    std::size_t bytes_processed = 0;
+    /// Number of bytes of string contents, including dict keys.
+    std::size_t string_bytes = 0;
+    std::size_t integer_count = 0;
+    /// Number of strings, including dict keys.
+    std::size_t string_count = 0;
+    std::size_t list_count = 0;
+    std::size_t dict_count = 0;
+    /// Deepest nesting level of lists and dicts.
+    std::size_t max_depth = 0;
+    /// Wall clock time spent in parse.
+    std::chrono::nanoseconds parse_time {};
+    /// Number of failed parses per error code, indexed by the value of parsing_errc.
+    std::array<std::size_t, parsing_errc_count> error_counts {};
+
+    /// Number of bytes used for structure: integer tokens, string length prefixes
+    /// and list and dict begin and end tokens.
+    constexpr std::size_t framing_bytes() const noexcept
+    { return bytes_processed - string_bytes; }
+
+    constexpr std::size_t token_count() const noexcept
+    { return integer_count + string_count + list_count + dict_count; }
+
+    /// Total number of failed parses.
+    constexpr std::size_t error_count() const noexcept
+    {
+        std::size_t n = 0;
+        for (auto c : error_counts) n += c;
+        return n;
+    }
+
+    /// Number of failed parses with given error code.
+    constexpr std::size_t error_count(parsing_errc ec) const noexcept
+    { return error_counts[static_cast<std::size_t>(ec)]; }
+};
+
+/// Instrumentation policy that collects parser_stats.
+class stats_instrumentation
+{
+    using clock = std::chrono::steady_clock;
+
+public:
+    static constexpr bool enabled = true;
+
+    void on_parse_begin() noexcept
+    {
+        ++stats_.parse_count;
+        start_ = clock::now();
+    }
+
+    void on_parse_end(std::size_t bytes, const std::optional<parsing_error>& error) noexcept
+    {
+        stats_.parse_time += clock::now() - start_;
+        stats_.bytes_processed += bytes;
+        if (error) [[unlikely]]
+            ++stats_.error_counts[static_cast<std::size_t>(error->errc())];
+    }
+
+    void on_integer() noexcept
+    { ++stats_.integer_count; }
+
+    void on_string(std::size_t size) noexcept
+    {
+        ++stats_.string_count;
+        stats_.string_bytes += size;
+    }
+
+    void on_begin_list(std::size_t depth) noexcept
+    {
+        ++stats_.list_count;
+        stats_.max_depth = std::max(stats_.max_depth, depth);
+    }
+
+    void on_begin_dict(std::size_t depth) noexcept
+    {
+        ++stats_.dict_count;
+        stats_.max_depth = std::max(stats_.max_depth, depth);
+    }
+
+    const parser_stats& stats() const noexcept
+    { return stats_; }
+
+    void reset() noexcept
+    { stats_ = {}; }
+
+private:
+    parser_stats stats_ {};
+    clock::time_point start_ {};
+};
+
+static_assert(parser_instrumentation<no_instrumentation>);
+static_assert(parser_instrumentation<stats_instrumentation>);
+
+} // namespace bencode
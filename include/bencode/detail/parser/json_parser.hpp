@@ -0,0 +1,661 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gsl/gsl_assert>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/events/concepts.hpp"
+#include "bencode/detail/parser/common.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+namespace bencode {
+
+namespace detail {
+
+enum class json_token_type : std::uint8_t
+{
+    integer,
+    string,
+    /// string with escape sequences, stored unescaped in the parser
+    escaped_string,
+    list,
+    object,
+};
+
+/// An event recorded while parsing a json value, before it is passed to a consumer.
+struct json_token
+{
+    json_token_type type;
+    /// string: length, list and object: number of elements
+    std::size_t size;
+    /// integer: value, string: offset in the input or in the unescaped string storage,
+    /// object: offset of its members in the sorted member index
+    std::int64_t value;
+    /// list and object: index one past the last token of the value
+    std::size_t end;
+};
+
+/// A member of a json object that is not closed yet.
+struct json_object_member
+{
+    /// index of the token of the key
+    std::size_t key;
+    /// offset of the key in the input
+    std::size_t position;
+};
+
+struct json_parser_stack_frame
+{
+    bool is_object;
+    /// index of the token of the list or object
+    std::size_t token;
+    /// object: index of the first member in the pending member list
+    std::size_t first_member;
+};
+
+/// A list or object of which events are being passed to a consumer.
+struct json_emit_frame
+{
+    bool is_object;
+    /// list: index of the next token, object: index of the next member in the sorted member index
+    std::size_t next;
+    std::size_t last;
+    std::size_t size;
+};
+
+constexpr bool is_json_whitespace(char c) noexcept
+{ return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+/// Returns true for characters that must be escaped in a json string.
+constexpr bool is_json_control_character(char c) noexcept
+{ return static_cast<unsigned char>(c) < 0x20; }
+
+/// Returns a pointer to the first '"', '\\' or control character in [first, last)
+/// or last if not found.
+inline const char* find_json_string_special(const char* first, const char* last) noexcept
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i max_control = _mm_set1_epi8(0x1F);
+
+    for (; last - first >= 16; first += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        // unsigned v <= 0x1F
+        const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(v, max_control), max_control);
+        const int mask = _mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), control));
+        if (mask != 0)
+            return first + std::countr_zero(static_cast<unsigned>(mask));
+    }
+#endif
+    for (; first != last; ++first) {
+        if (*first == '"' || *first == '\\' || is_json_control_character(*first)) break;
+    }
+    return first;
+}
+
+/// Append the UTF-8 encoding of a code point to out.
+inline void append_utf8(std::string& out, std::uint32_t cp)
+{
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+} // namespace detail
+
+
+/// Parse JSON and pass generated events to an event consumer.
+///
+/// This allows to transcode JSON to bencode with events::encode_to or to build
+/// a basic_bvalue with events::to_bvalue without an intermediate representation.
+///
+/// JSON types without a bencode counterpart are handled as follows:
+///     * true and false are passed as the integers 1 and 0.
+///     * null and numbers with a fraction or exponent are rejected.
+///
+/// Bencode requires dict keys to be sorted. Each top-level value is parsed in a single pass
+/// into a buffer of events. When an object is closed its members are sorted by key,
+/// and once the value is complete the events are passed to the consumer in sorted key order.
+/// Every input character is scanned once and every buffered event is replayed once.
+/// Strings without escape sequences are not copied, the event buffers are reused between values.
+/// Duplicate keys are rejected.
+class json_parser
+{
+    using token = detail::json_token;
+    using token_type = detail::json_token_type;
+    using member = detail::json_object_member;
+    using stack_frame = detail::json_parser_stack_frame;
+    using emit_frame = detail::json_emit_frame;
+
+public:
+    using options = parser_options;
+
+    explicit json_parser(const options& options = {})
+            : options_(options)
+    {}
+
+    /// Parse a string_view and pass generated events to the event consumer.
+    /// Multiple JSON values separated by whitespace are parsed as successive values.
+    /// The events of a value are passed to the consumer after the complete value is parsed.
+    /// Strings with escape sequences are passed from an internal buffer,
+    /// so consumers that keep the string_views they receive are not accepted.
+    /// @returns true if successful, false if an error occurred.
+    template <event_consumer EC>
+        requires (!borrowing_event_consumer<EC>)
+    bool parse(EC& consumer, std::string_view s)
+    {
+        begin_ = s.data();
+        it_ = s.data();
+        end_ = s.data() + s.size();
+        error_ = std::nullopt;
+        stack_.clear();
+        reset_value();
+        value_count_ = 0;
+
+        return parse_loop(consumer);
+    }
+
+    bool has_error() const noexcept
+    { return error_.has_value(); }
+
+    parsing_error error() const
+    {
+        Expects(error_.has_value());
+        return *error_;
+    }
+
+private:
+    template <event_consumer EC>
+    bool parse_loop(EC& consumer)
+    {
+        while (!has_error()) {
+            if (stack_.empty()) {
+                skip_whitespace();
+                if (it_ == end_) break;
+                handle_value(consumer);
+                continue;
+            }
+            if (stack_.back().is_object)
+                handle_object_member(consumer);
+            else
+                handle_list_item(consumer);
+        }
+        return !has_error();
+    }
+
+    template <event_consumer EC>
+    bool handle_value(EC& consumer)
+    {
+        if (it_ == end_) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof);
+            return false;
+        }
+        if (++value_count_ > options_.value_limit) [[unlikely]] {
+            set_error(parsing_errc::value_limit_exceeded);
+            return false;
+        }
+
+        switch (*it_) {
+        case '{':
+            return handle_container_begin(true);
+        case '[':
+            return handle_container_begin(false);
+        case '"': {
+            if (!push_string()) [[unlikely]] return false;
+            return handle_value_end(consumer);
+        }
+        case 't':
+            if (!match_literal("true")) [[unlikely]] return false;
+            tokens_.push_back({.type = token_type::integer, .size = 0, .value = 1, .end = 0});
+            return handle_value_end(consumer);
+        case 'f':
+            if (!match_literal("false")) [[unlikely]] return false;
+            tokens_.push_back({.type = token_type::integer, .size = 0, .value = 0, .end = 0});
+            return handle_value_end(consumer);
+        case 'n':
+            set_error(parsing_errc::unsupported_json_value);
+            return false;
+        default:
+            if (*it_ == '-' || *it_ == symbol::digit) [[likely]] {
+                return handle_integer(consumer);
+            }
+            set_error(parsing_errc::expected_json_value);
+            return false;
+        }
+    }
+
+    template <event_consumer EC>
+    bool handle_integer(EC& consumer)
+    {
+        auto result = detail::parse_integer<std::int64_t>(it_, end_);
+        if (!result) [[unlikely]] {
+            set_error(result.error(), btype::integer);
+            return false;
+        }
+        if (it_ != end_ && (*it_ == '.' || *it_ == 'e' || *it_ == 'E')) [[unlikely]] {
+            set_error(parsing_errc::unsupported_json_value);
+            return false;
+        }
+        tokens_.push_back({.type = token_type::integer, .size = 0, .value = *result, .end = 0});
+        return handle_value_end(consumer);
+    }
+
+    /// Count a completed value in its parent, or pass the events of a completed
+    /// top-level value to the consumer.
+    template <event_consumer EC>
+    bool handle_value_end(EC& consumer)
+    {
+        if (stack_.empty()) {
+            emit(consumer);
+            reset_value();
+            return true;
+        }
+        if (!stack_.back().is_object) {
+            ++tokens_[stack_.back().token].size;
+        }
+        return true;
+    }
+
+    bool handle_container_begin(bool is_object)
+    {
+        if (stack_.size() >= options_.recursion_limit) [[unlikely]] {
+            set_error(parsing_errc::recursion_depth_exceeded);
+            return false;
+        }
+        ++it_;
+        stack_.push_back({.is_object = is_object, .token = tokens_.size(), .first_member = members_.size()});
+        tokens_.push_back({.type = is_object ? token_type::object : token_type::list,
+                           .size = 0, .value = 0, .end = 0});
+        return true;
+    }
+
+    template <event_consumer EC>
+    bool handle_list_item(EC& consumer)
+    {
+        skip_whitespace();
+        if (it_ == end_) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof, btype::list);
+            return false;
+        }
+        const auto& frame = stack_.back();
+        if (*it_ == ']') {
+            ++it_;
+            tokens_[frame.token].end = tokens_.size();
+            stack_.pop_back();
+            return handle_value_end(consumer);
+        }
+        if (tokens_[frame.token].size != 0) {
+            if (*it_ != ',') [[unlikely]] {
+                set_error(parsing_errc::expected_json_comma_or_end, btype::list);
+                return false;
+            }
+            ++it_;
+            skip_whitespace();
+            if (it_ != end_ && *it_ == ']') [[unlikely]] {
+                set_error(parsing_errc::expected_json_value, btype::list);
+                return false;
+            }
+        }
+        return handle_value(consumer);
+    }
+
+    template <event_consumer EC>
+    bool handle_object_member(EC& consumer)
+    {
+        skip_whitespace();
+        if (it_ == end_) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof, btype::dict);
+            return false;
+        }
+        const auto& frame = stack_.back();
+        if (*it_ == '}') {
+            ++it_;
+            if (!close_object()) [[unlikely]] return false;
+            return handle_value_end(consumer);
+        }
+        if (members_.size() != frame.first_member) {
+            if (*it_ != ',') [[unlikely]] {
+                set_error(parsing_errc::expected_json_comma_or_end, btype::dict);
+                return false;
+            }
+            ++it_;
+            skip_whitespace();
+        }
+        if (it_ == end_ || *it_ != '"') [[unlikely]] {
+            set_error(parsing_errc::expected_json_string, btype::dict);
+            return false;
+        }
+
+        const auto position = static_cast<std::size_t>(it_ - begin_);
+        members_.push_back({.key = tokens_.size(), .position = position});
+        if (!push_string()) [[unlikely]] return false;
+
+        skip_whitespace();
+        if (it_ == end_ || *it_ != ':') [[unlikely]] {
+            set_error(parsing_errc::expected_json_colon, btype::dict);
+            return false;
+        }
+        ++it_;
+        skip_whitespace();
+        return handle_value(consumer);
+    }
+
+    /// Sort the members of the innermost object by key and record the order in the sorted member index.
+    bool close_object()
+    {
+        const auto frame = stack_.back();
+        const auto first = std::next(members_.begin(), static_cast<std::ptrdiff_t>(frame.first_member));
+        const auto last = members_.end();
+
+        const auto key_less = [this](const member& lhs, const member& rhs)
+        { return string_value(tokens_[lhs.key]) < string_value(tokens_[rhs.key]); };
+        const auto key_equal = [this](const member& lhs, const member& rhs)
+        { return string_value(tokens_[lhs.key]) == string_value(tokens_[rhs.key]); };
+
+        if (!std::is_sorted(first, last, key_less)) {
+            std::sort(first, last, key_less);
+        }
+        if (auto dup = std::adjacent_find(first, last, key_equal); dup != last) [[unlikely]] {
+            it_ = begin_ + std::next(dup)->position;
+            set_error(parsing_errc::duplicate_dict_key, btype::dict);
+            return false;
+        }
+
+        auto& t = tokens_[frame.token];
+        t.size = static_cast<std::size_t>(last - first);
+        t.value = static_cast<std::int64_t>(sorted_members_.size());
+        t.end = tokens_.size();
+        for (auto it = first; it != last; ++it) {
+            sorted_members_.push_back(it->key);
+        }
+        members_.erase(first, last);
+        stack_.pop_back();
+        return true;
+    }
+
+    /// Parse a string and record it as a token.
+    bool push_string()
+    {
+        auto s = parse_string(string_buffer_);
+        if (!s) [[unlikely]] return false;
+
+        if (s->data() == string_buffer_.data()) {
+            tokens_.push_back({.type = token_type::escaped_string, .size = s->size(),
+                               .value = static_cast<std::int64_t>(unescaped_.size()), .end = 0});
+            unescaped_.append(*s);
+        }
+        else {
+            tokens_.push_back({.type = token_type::string, .size = s->size(),
+                               .value = static_cast<std::int64_t>(s->data() - begin_), .end = 0});
+        }
+        return true;
+    }
+
+    std::string_view string_value(const token& t) const noexcept
+    {
+        const char* base = t.type == token_type::string ? begin_ : unescaped_.data();
+        return std::string_view(base + t.value, t.size);
+    }
+
+    /// Pass the recorded events of a completed top-level value to the consumer,
+    /// with the members of objects in sorted key order.
+    template <event_consumer EC>
+    void emit(EC& consumer)
+    {
+        emit_stack_.clear();
+
+        // emit events for a scalar value or the start of a container,
+        // returns true when a container was opened
+        auto open = [&](std::size_t i) -> bool {
+            const auto& t = tokens_[i];
+            switch (t.type) {
+            case token_type::integer:
+                consumer.integer(t.value);
+                return false;
+            case token_type::string:
+            case token_type::escaped_string:
+                consumer.string(string_value(t));
+                return false;
+            case token_type::list:
+                consumer.begin_list(t.size);
+                emit_stack_.push_back({.is_object = false, .next = i + 1, .last = t.end, .size = t.size});
+                return true;
+            case token_type::object: {
+                const auto first = static_cast<std::size_t>(t.value);
+                consumer.begin_dict(t.size);
+                emit_stack_.push_back({.is_object = true, .next = first, .last = first + t.size, .size = t.size});
+                return true;
+            }
+            }
+            return false;
+        };
+
+        // emit the event that closes an element of the enclosing container
+        auto close_element = [&]() {
+            if (emit_stack_.empty()) return;
+            if (emit_stack_.back().is_object) consumer.dict_value();
+            else consumer.list_item();
+        };
+
+        if (!open(0)) return;
+
+        while (!emit_stack_.empty()) {
+            auto& f = emit_stack_.back();
+            if (f.next == f.last) {
+                if (f.is_object) consumer.end_dict(f.size);
+                else consumer.end_list(f.size);
+                emit_stack_.pop_back();
+                close_element();
+                continue;
+            }
+
+            std::size_t i;
+            if (f.is_object) {
+                const auto key = sorted_members_[f.next++];
+                consumer.string(string_value(tokens_[key]));
+                consumer.dict_key();
+                i = key + 1;
+            }
+            else {
+                i = f.next;
+                const auto& t = tokens_[i];
+                f.next = (t.type == token_type::list || t.type == token_type::object) ? t.end : i + 1;
+            }
+            if (!open(i)) close_element();
+        }
+    }
+
+    /// Clear the event buffers, keeping their capacity.
+    void reset_value() noexcept
+    {
+        tokens_.clear();
+        members_.clear();
+        sorted_members_.clear();
+        unescaped_.clear();
+    }
+
+    /// Parse a json string at the current position.
+    /// Unescaped control characters are rejected.
+    /// @returns a view into the input when the string contains no escape sequences,
+    ///     otherwise a view to the unescaped string stored in buffer.
+    std::optional<std::string_view> parse_string(std::string& buffer)
+    {
+        Expects(*it_ == '"');
+        ++it_;
+        const char* first = it_;
+        it_ = detail::find_json_string_special(it_, end_);
+
+        if (it_ == end_) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof, btype::string);
+            return std::nullopt;
+        }
+        if (*it_ == '"') [[likely]] {
+            return std::string_view(first, it_++);
+        }
+
+        buffer.assign(first, it_);
+        while (true) {
+            if (it_ == end_) [[unlikely]] {
+                set_error(parsing_errc::unexpected_eof, btype::string);
+                return std::nullopt;
+            }
+            if (*it_ == '"') {
+                ++it_;
+                return std::string_view(buffer);
+            }
+            if (*it_ != '\\') [[unlikely]] {
+                set_error(parsing_errc::expected_json_string, btype::string);
+                return std::nullopt;
+            }
+            if (!unescape(buffer)) [[unlikely]] return std::nullopt;
+
+            const char* run = it_;
+            it_ = detail::find_json_string_special(it_, end_);
+            buffer.append(run, it_);
+        }
+    }
+
+    /// Decode the escape sequence at the current position and append it to buffer.
+    bool unescape(std::string& buffer)
+    {
+        Expects(*it_ == '\\');
+        ++it_;
+        if (it_ == end_) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof, btype::string);
+            return false;
+        }
+
+        switch (*it_++) {
+        case '"':  buffer.push_back('"');  return true;
+        case '\\': buffer.push_back('\\'); return true;
+        case '/':  buffer.push_back('/');  return true;
+        case 'b':  buffer.push_back('\b'); return true;
+        case 'f':  buffer.push_back('\f'); return true;
+        case 'n':  buffer.push_back('\n'); return true;
+        case 'r':  buffer.push_back('\r'); return true;
+        case 't':  buffer.push_back('\t'); return true;
+        case 'u':  break;
+        default:
+            --it_;
+            set_error(parsing_errc::invalid_json_escape, btype::string);
+            return false;
+        }
+
+        auto cp = parse_hex4();
+        if (!cp) [[unlikely]] return false;
+
+        // combine surrogate pairs
+        if (*cp >= 0xD800 && *cp <= 0xDBFF) {
+            if (end_ - it_ < 2 || it_[0] != '\\' || it_[1] != 'u') [[unlikely]] {
+                set_error(parsing_errc::invalid_json_escape, btype::string);
+                return false;
+            }
+            it_ += 2;
+            auto low = parse_hex4();
+            if (!low) [[unlikely]] return false;
+            if (*low < 0xDC00 || *low > 0xDFFF) [[unlikely]] {
+                set_error(parsing_errc::invalid_json_escape, btype::string);
+                return false;
+            }
+            cp = 0x10000 + ((*cp - 0xD800) << 10) + (*low - 0xDC00);
+        }
+        else if (*cp >= 0xDC00 && *cp <= 0xDFFF) [[unlikely]] {
+            set_error(parsing_errc::invalid_json_escape, btype::string);
+            return false;
+        }
+        detail::append_utf8(buffer, *cp);
+        return true;
+    }
+
+    std::optional<std::uint32_t> parse_hex4() noexcept
+    {
+        if (end_ - it_ < 4) [[unlikely]] {
+            set_error(parsing_errc::unexpected_eof, btype::string);
+            return std::nullopt;
+        }
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i, ++it_) {
+            const char c = *it_;
+            value <<= 4;
+            if (c >= '0' && c <= '9')      value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else [[unlikely]] {
+                set_error(parsing_errc::invalid_json_escape, btype::string);
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    bool match_literal(std::string_view literal) noexcept
+    {
+        if (static_cast<std::size_t>(end_ - it_) < literal.size() ||
+            std::memcmp(it_, literal.data(), literal.size()) != 0) [[unlikely]] {
+            set_error(parsing_errc::invalid_json_literal);
+            return false;
+        }
+        it_ += literal.size();
+        return true;
+    }
+
+    void skip_whitespace() noexcept
+    {
+        while (it_ != end_ && detail::is_json_whitespace(*it_)) ++it_;
+    }
+
+    void set_error(parsing_errc ec, std::optional<bencode_type> context = std::nullopt) noexcept
+    {
+        error_.emplace(ec, static_cast<std::size_t>(it_ - begin_), context);
+    }
+
+    const char* begin_ = nullptr;
+    const char* it_ = nullptr;
+    const char* end_ = nullptr;
+    std::vector<stack_frame> stack_ {};
+    /// events of the current top-level value
+    std::vector<token> tokens_ {};
+    /// members of the objects that are not closed yet
+    std::vector<member> members_ {};
+    /// key token indices of the members of closed objects, in sorted order per object
+    std::vector<std::size_t> sorted_members_ {};
+    /// unescaped strings of the current top-level value
+    std::string unescaped_ {};
+    /// scratch buffer to unescape a string
+    std::string string_buffer_ {};
+    std::vector<emit_frame> emit_stack_ {};
+    std::optional<parsing_error> error_;
+    std::uint32_t value_count_ = 0;
+    options options_;
+};
+
+} // namespace bencode
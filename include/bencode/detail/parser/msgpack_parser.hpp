@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <nonstd/expected.hpp>
+
+#include "bencode/detail/parser/binary_parser.hpp"
+
+namespace bencode {
+
+namespace detail {
+
+/// Reader for MessagePack object headers.
+struct msgpack_format
+{
+    static constexpr parsing_errc invalid_item = parsing_errc::invalid_msgpack_item;
+    static constexpr bool strings_point_into_input = true;
+
+    static nonstd::expected<binary_item, parsing_errc>
+    read(const char*& it, const char* end, [[maybe_unused]] std::string& buffer)
+    {
+        using nonstd::make_unexpected;
+
+        if (it == end) [[unlikely]]
+            return make_unexpected(parsing_errc::unexpected_eof);
+
+        const auto type = static_cast<unsigned char>(*it++);
+
+        // positive fixint
+        if (type <= 0x7F)
+            return integer(type);
+        // fixmap
+        if (type <= 0x8F)
+            return container(binary_item_kind::dict, type & 0x0F, it, end);
+        // fixarray
+        if (type <= 0x9F)
+            return container(binary_item_kind::list, type & 0x0F, it, end);
+        // fixstr
+        if (type <= 0xBF)
+            return string(type & 0x1F, it, end);
+        // negative fixint
+        if (type >= 0xE0)
+            return integer(static_cast<std::int8_t>(type));
+
+        switch (type) {
+        case 0xC2: return integer(0);
+        case 0xC3: return integer(1);
+        // bin 8/16/32 and str 8/16/32
+        case 0xC4: case 0xD9: return string_n<1>(it, end);
+        case 0xC5: case 0xDA: return string_n<2>(it, end);
+        case 0xC6: case 0xDB: return string_n<4>(it, end);
+        // uint 8/16/32/64
+        case 0xCC: return unsigned_n<1>(it, end);
+        case 0xCD: return unsigned_n<2>(it, end);
+        case 0xCE: return unsigned_n<4>(it, end);
+        case 0xCF: return unsigned_n<8>(it, end);
+        // int 8/16/32/64
+        case 0xD0: return signed_n<std::int8_t>(it, end);
+        case 0xD1: return signed_n<std::int16_t>(it, end);
+        case 0xD2: return signed_n<std::int32_t>(it, end);
+        case 0xD3: return signed_n<std::int64_t>(it, end);
+        // array 16/32 and map 16/32
+        case 0xDC: return container_n<2>(binary_item_kind::list, it, end);
+        case 0xDD: return container_n<4>(binary_item_kind::list, it, end);
+        case 0xDE: return container_n<2>(binary_item_kind::dict, it, end);
+        case 0xDF: return container_n<4>(binary_item_kind::dict, it, end);
+        // never used
+        case 0xC1: return make_unexpected(parsing_errc::invalid_msgpack_item);
+        // nil, float and ext types
+        default:   return make_unexpected(parsing_errc::unsupported_msgpack_value);
+        }
+    }
+
+private:
+    static binary_item integer(std::int64_t value) noexcept
+    { return {.kind = binary_item_kind::integer, .integer = value}; }
+
+    static nonstd::expected<binary_item, parsing_errc>
+    string(std::size_t size, const char*& it, const char* end) noexcept
+    {
+        if (size > std::size_t(end - it)) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+        it += size;
+        return binary_item{.kind = binary_item_kind::string, .string = std::string_view(it - size, size)};
+    }
+
+    static nonstd::expected<binary_item, parsing_errc>
+    container(binary_item_kind kind, std::size_t size, const char*& it, const char* end) noexcept
+    {
+        // every object takes at least one byte
+        const auto min_bytes = kind == binary_item_kind::dict ? 2 * size : size;
+        if (min_bytes > std::size_t(end - it)) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+        return binary_item{.kind = kind, .size = size};
+    }
+
+    template <std::size_t N>
+    static nonstd::expected<std::uint64_t, parsing_errc>
+    read_n(const char*& it, const char* end) noexcept
+    {
+        if (std::size_t(end - it) < N) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::unexpected_eof);
+        auto value = load_big_endian<N>(it);
+        it += N;
+        return value;
+    }
+
+    template <std::size_t N>
+    static nonstd::expected<binary_item, parsing_errc>
+    string_n(const char*& it, const char* end) noexcept
+    {
+        auto size = read_n<N>(it, end);
+        if (!size) [[unlikely]] return nonstd::make_unexpected(size.error());
+        return string(*size, it, end);
+    }
+
+    template <std::size_t N>
+    static nonstd::expected<binary_item, parsing_errc>
+    container_n(binary_item_kind kind, const char*& it, const char* end) noexcept
+    {
+        auto size = read_n<N>(it, end);
+        if (!size) [[unlikely]] return nonstd::make_unexpected(size.error());
+        return container(kind, *size, it, end);
+    }
+
+    template <std::size_t N>
+    static nonstd::expected<binary_item, parsing_errc>
+    unsigned_n(const char*& it, const char* end) noexcept
+    {
+        auto value = read_n<N>(it, end);
+        if (!value) [[unlikely]] return nonstd::make_unexpected(value.error());
+        if (*value > std::uint64_t(std::numeric_limits<std::int64_t>::max())) [[unlikely]]
+            return nonstd::make_unexpected(parsing_errc::integer_overflow);
+        return integer(static_cast<std::int64_t>(*value));
+    }
+
+    template <std::signed_integral T>
+    static nonstd::expected<binary_item, parsing_errc>
+    signed_n(const char*& it, const char* end) noexcept
+    {
+        auto value = read_n<sizeof(T)>(it, end);
+        if (!value) [[unlikely]] return nonstd::make_unexpected(value.error());
+        return integer(static_cast<T>(*value));
+    }
+};
+
+} // namespace detail
+
+/// Parse MessagePack and pass generated events to an event consumer.
+///
+/// str and bin objects are both passed as strings.
+/// false and true are passed as the integers 0 and 1.
+/// nil, floating point numbers, extension types and integers that do not fit
+/// in a std::int64_t are rejected.
+/// Map keys must be strings and are passed to the consumer in sorted order.
+using msgpack_parser = detail::binary_parser<detail::msgpack_format>;
+
+} // namespace bencode
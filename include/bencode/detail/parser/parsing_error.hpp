@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <exception>
 #include <system_error>
 #include <string>
+#include <optional>
 
 #include <gsl/gsl>
 #include <fmt/format.h>
@@ -32,8 +34,28 @@ enum class parsing_errc {
     recursion_depth_exceeded,
     value_limit_exceeded,
     internal_error,
+    // json input errors
+    expected_json_value,
+    expected_json_string,
+    expected_json_colon,
+    expected_json_comma_or_end,
+    invalid_json_literal,
+    invalid_json_escape,
+    unsupported_json_value,
+    duplicate_dict_key,
+    // cbor and msgpack input errors
+    expected_string_dict_key,
+    invalid_cbor_item,
+    unsupported_cbor_value,
+    invalid_msgpack_item,
+    unsupported_msgpack_value,
+    // update parsing_errc_count below when adding error codes
 };
 
+/// One past the largest value of parsing_errc, used to size per error code counters.
+inline constexpr std::size_t parsing_errc_count =
+        static_cast<std::size_t>(parsing_errc::unsupported_msgpack_value) + 1;
+
 /// Converts ec to a string.
 /// @param ec an error code
 /// @returns String representation of an error code.
@@ -71,11 +93,40 @@ constexpr std::string_view to_string(parsing_errc ec) {
         return "invalid string length";
     case parsing_errc::internal_error:
         return "internal error";
+    case parsing_errc::expected_json_value:
+        return "expected begin of a json value";
+    case parsing_errc::expected_json_string:
+        return "expected a json string";
+    case parsing_errc::expected_json_colon:
+        return "expected name separator ':'";
+    case parsing_errc::expected_json_comma_or_end:
+        return "expected value separator ',' or end of array/object";
+    case parsing_errc::invalid_json_literal:
+        return "invalid json literal";
+    case parsing_errc::invalid_json_escape:
+        return "invalid escape sequence in json string";
+    case parsing_errc::unsupported_json_value:
+        return "json value has no bencode representation (null or non-integral number)";
+    case parsing_errc::duplicate_dict_key:
+        return "duplicate dict key";
+    case parsing_errc::expected_string_dict_key:
+        return "dict key must be a string";
+    case parsing_errc::invalid_cbor_item:
+        return "malformed cbor data item";
+    case parsing_errc::unsupported_cbor_value:
+        return "cbor value has no bencode representation (null, undefined, float or simple value)";
+    case parsing_errc::invalid_msgpack_item:
+        return "malformed msgpack object";
+    case parsing_errc::unsupported_msgpack_value:
+        return "msgpack value has no bencode representation (nil, float or extension type)";
     default:
         return "(unrecognised error)";
     };
 }
 
+static_assert(to_string(static_cast<parsing_errc>(parsing_errc_count)) == "(unrecognised error)",
+              "parsing_errc_count must be one past the last error code");
+
 struct parsing_category : std::error_category
 {
     const char* name() const noexcept override
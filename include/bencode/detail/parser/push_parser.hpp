@@ -3,6 +3,9 @@
 #include <system_error>
 #include <stack>
 #include <istream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 #include <nonstd/expected.hpp>
 
@@ -12,6 +15,7 @@
 #include "bencode/detail/utils.hpp"
 #include "bencode/detail/bencode_type.hpp"
 #include "bencode/detail/parser/common.hpp"
+#include "bencode/detail/parser/instrumentation.hpp"
 
 
 #include "parsing_error.hpp"
@@ -20,12 +24,18 @@ namespace bencode {
 
 namespace rng = std::ranges;
 
-template <typename Iterator = const char*, typename Sentinel = Iterator>
+/// Parse bencoded data and pass events to an event consumer.
+/// For contiguous input the strings passed to the consumer are views into the input,
+/// other input is copied to a temporary std::string.
+/// @tparam Instrumentation policy receiving parser metrics, see stats_instrumentation.
+template <typename Iterator = const char*, typename Sentinel = Iterator,
+          parser_instrumentation Instrumentation = no_instrumentation>
 class push_parser
 {
     using state      = detail::parser_state;
     using iterator_t = Iterator;
     using sentinel_t = Sentinel;
+    using string_t   = std::conditional_t<std::contiguous_iterator<Iterator>, std::string_view, std::string>;
 
 public:
     using options = parser_options;
@@ -44,8 +54,18 @@ public:
         it_ = rng::begin(range);
         end_ = rng::end(range);
         error_ = std::nullopt;
+        value_count_ = 0;
+        // discard the parse context left behind by a previous failed parse
+        if (!stack_.empty()) stack_ = {};
 
+        instrumentation_.on_parse_begin();
         auto result = parse_loop(consumer);
+        if constexpr (Instrumentation::enabled) {
+            std::size_t bytes = 0;
+            if constexpr (std::forward_iterator<iterator_t>)
+                bytes = static_cast<std::size_t>(std::distance(begin_, it_));
+            instrumentation_.on_parse_end(bytes, error_);
+        }
         return result;
     }
 
@@ -64,6 +84,14 @@ public:
         return *error_;
     }
 
+    /// Returns the instrumentation policy instance.
+    /// The number of processed bytes is only recorded for forward iterators.
+    const Instrumentation& instrumentation() const noexcept
+    { return instrumentation_; }
+
+    Instrumentation& instrumentation() noexcept
+    { return instrumentation_; }
+
 private:
     template <event_consumer EC>
     bool parse_loop(EC& consumer)
@@ -147,6 +175,9 @@ private:
             if (stack_.top() == detail::parser_state::expect_list_value) {
                 set_error(parsing_errc::expected_list_value_or_end);
             }
+            if (stack_.top() == detail::parser_state::expect_dict_value) {
+                set_error(parsing_errc::expected_dict_value, btype::dict);
+            }
             return false;
         }
 
@@ -168,6 +199,7 @@ private:
         }
 
         consumer.integer(*value);
+        instrumentation_.on_integer();
         ++value_count_;
         return true;
     }
@@ -177,11 +209,12 @@ private:
     {
         Expects(*it_ == symbol::digit);
 
-        auto value = detail::bdecode_string(it_, end_);
+        auto value = detail::bdecode_string<string_t>(it_, end_);
         if (!value) [[unlikely]] {
             set_error(value.error(), btype::string);
             return false;
         }
+        instrumentation_.on_string(value->size());
         consumer.string(*value);
         ++value_count_;
         return true;
@@ -244,6 +277,7 @@ private:
         }
         ++it_;
         stack_.push(state::expect_list_value);
+        instrumentation_.on_begin_list(stack_.size());
         consumer.begin_list();
         ++value_count_;
         return true;
@@ -260,6 +294,7 @@ private:
         }
         ++it_;
         stack_.push(state::expect_dict_key);
+        instrumentation_.on_begin_dict(stack_.size());
         consumer.begin_dict();
         ++value_count_;
         return true;
@@ -298,13 +333,14 @@ private:
         Expects(stack_.top() == state::expect_dict_key);
         Expects(*it_ == symbol::digit);
 
-        auto value = detail::bdecode_string<std::string>(it_, end_);
+        auto value = detail::bdecode_string<string_t>(it_, end_);
 
         if (!value) [[unlikely]] {
             set_error(value.error(), btype::string);
             return false;
         }
         stack_.top() = state::expect_dict_value;
+        instrumentation_.on_string(value->size());
         consumer.string(std::move(*value));
         consumer.dict_key();
         return true;
@@ -340,6 +376,7 @@ private:
     std::optional<parsing_error> error_;
     std::uint32_t value_count_ = 0;
     options options_;
+    [[no_unique_address]] Instrumentation instrumentation_ {};
 };
 
 } // namespace bencode
\ No newline at end of file
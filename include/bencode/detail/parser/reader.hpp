@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include <gsl/gsl_assert>
+
+#include "bencode/detail/bencode_type.hpp"
+#include "bencode/detail/symbol.hpp"
+#include "bencode/detail/parser/common.hpp"
+#include "bencode/detail/parser/parsing_error.hpp"
+
+namespace bencode {
+
+/// Enumeration of the tokens returned by reader::next().
+enum class reader_token : std::uint8_t
+{
+    integer,
+    string,
+    begin_list,
+    begin_dict,
+    /// end of the current list or dict
+    end,
+    /// end of the input outside of any list or dict
+    eof,
+};
+
+/// Pull parser that reads bencoded data token by token from a contiguous buffer.
+///
+/// Unlike push_parser the caller controls which values are read,
+/// and unlike descriptor_parser nothing is indexed. Values that are not needed
+/// can be skipped with skip_value() which only follows string length prefixes and
+/// structure tokens without building anything.
+///
+/// All read functions throw parsing_error when the input is malformed or
+/// the next token is not of the requested type.
+///
+/// @code
+/// auto r = bencode::reader(data);
+/// r.enter_dict();
+/// if (r.seek_key("t")) transaction_id = r.read_string();
+/// if (r.seek_key("y")) type = r.read_string();
+/// r.leave();
+/// @endcode
+class reader
+{
+public:
+    using options = parser_options;
+
+    explicit reader(std::string_view data, const options& options = {}) noexcept
+            : begin_(data.data())
+            , it_(data.data())
+            , end_(data.data() + data.size())
+            , options_(options)
+    {}
+
+    /// Construct a reader that starts reading at offset pos of data.
+    /// Positions and error positions are relative to the start of data.
+    reader(std::string_view data, std::size_t pos, const options& options = {}) noexcept
+            : reader(data, options)
+    {
+        Expects(pos <= data.size());
+        it_ += pos;
+    }
+
+    /// Returns the type of the next token without consuming it.
+    /// @throws parsing_error if the next token is not valid at the current position.
+    reader_token next() const
+    {
+        if (it_ == end_) {
+            if (depth_ != 0) [[unlikely]] throw make_error(parsing_errc::unexpected_eof);
+            return reader_token::eof;
+        }
+        switch (*it_) {
+        case symbol::begin_integer:
+            return reader_token::integer;
+        case symbol::begin_list:
+            return reader_token::begin_list;
+        case symbol::begin_dict:
+            return reader_token::begin_dict;
+        case symbol::end:
+            if (depth_ == 0) [[unlikely]] throw make_error(parsing_errc::unexpected_end);
+            return reader_token::end;
+        default:
+            if (*it_ == symbol::digit) [[likely]] return reader_token::string;
+            throw make_error(parsing_errc::expected_value);
+        }
+    }
+
+    /// Consume an integer token and return its value.
+    std::int64_t read_integer()
+    {
+        auto value = detail::bdecode_integer<std::int64_t>(it_, end_);
+        if (!value) [[unlikely]] throw make_error(value.error(), btype::integer);
+        return *value;
+    }
+
+    /// Consume a string token and return a view to its contents in the input buffer.
+    std::string_view read_string()
+    {
+        auto value = read_string_token();
+        if (!value) [[unlikely]] throw make_error(value.error(), btype::string);
+        return *value;
+    }
+
+    /// Consume the begin token of a list.
+    void enter_list()
+    { enter(symbol::begin_list, btype::list); }
+
+    /// Consume the begin token of a dict.
+    /// Dict keys are read with read_string() or seek_key().
+    void enter_dict()
+    { enter(symbol::begin_dict, btype::dict); }
+
+    /// Skip the remaining values of the current list or dict and consume its end token.
+    void leave()
+    {
+        Expects(depth_ > 0);
+        while (next() != reader_token::end) {
+            skip_value();
+        }
+        ++it_;
+        --depth_;
+    }
+
+    /// Skip the remaining members of the current dict until key is found.
+    /// Keys are assumed to be sorted, so the search stops at the first greater key.
+    /// Must be called at a key position inside a dict.
+    /// @returns true and consumes the key when found, false when the key is not
+    ///     present, in which case the position is at the first greater key or the end token.
+    bool seek_key(std::string_view key)
+    {
+        Expects(depth_ > 0);
+        while (next() != reader_token::end) {
+            const char* key_begin = it_;
+            const auto k = read_string();
+            if (k == key) return true;
+            if (k > key) {
+                it_ = key_begin;
+                return false;
+            }
+            skip_value();
+        }
+        return false;
+    }
+
+    /// Skip the next value including all nested values.
+    /// The cost is proportional to the number of skipped bytes: string contents
+    /// are jumped over using the length prefix and integers are not decoded.
+    void skip_value()
+    {
+        std::size_t depth = 0;
+        do {
+            if (it_ == end_) [[unlikely]] throw make_error(parsing_errc::unexpected_eof);
+
+            switch (*it_) {
+            case symbol::begin_integer: {
+                const auto* e = static_cast<const char*>(std::memchr(it_, symbol::end, end_ - it_));
+                if (e == nullptr) [[unlikely]] throw make_error(parsing_errc::unexpected_eof, btype::integer);
+                it_ = e + 1;
+                break;
+            }
+            case symbol::begin_list:
+            case symbol::begin_dict:
+                if (depth_ + depth >= options_.recursion_limit) [[unlikely]]
+                    throw make_error(parsing_errc::recursion_depth_exceeded);
+                ++depth;
+                ++it_;
+                break;
+            case symbol::end:
+                if (depth == 0) [[unlikely]] throw make_error(parsing_errc::expected_value);
+                --depth;
+                ++it_;
+                break;
+            default:
+                if (*it_ != symbol::digit) [[unlikely]] throw make_error(parsing_errc::expected_value);
+                if (auto s = read_string_token(); !s) [[unlikely]]
+                    throw make_error(s.error(), btype::string);
+            }
+        } while (depth != 0);
+    }
+
+    /// Number of lists and dicts entered and not yet left.
+    std::size_t depth() const noexcept
+    { return depth_; }
+
+    /// Offset of the next token in the input buffer.
+    std::size_t position() const noexcept
+    { return static_cast<std::size_t>(it_ - begin_); }
+
+private:
+    void enter(char token, bencode_type type)
+    {
+        if (it_ == end_) [[unlikely]] throw make_error(parsing_errc::unexpected_eof, type);
+        if (*it_ != token) [[unlikely]] throw make_error(parsing_errc::expected_value, type);
+        if (depth_ >= options_.recursion_limit) [[unlikely]]
+            throw make_error(parsing_errc::recursion_depth_exceeded);
+        ++it_;
+        ++depth_;
+    }
+
+    nonstd::expected<std::string_view, parsing_errc> read_string_token() noexcept
+    {
+        const char* first = it_;
+        auto token = detail::bdecode_string_token(it_, end_);
+        if (!token) [[unlikely]]
+            return nonstd::make_unexpected(token.error());
+        return std::string_view(first + token->offset, token->size);
+    }
+
+    parsing_error make_error(parsing_errc ec, std::optional<bencode_type> context = std::nullopt) const
+    { return parsing_error(ec, position(), context); }
+
+    const char* begin_;
+    const char* it_;
+    const char* end_;
+    std::uint32_t depth_ = 0;
+    options options_;
+};
+
+} // namespace bencode
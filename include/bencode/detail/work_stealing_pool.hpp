@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bencode {
+
+/// Thread pool that processes batches of independent tasks identified by an index.
+///
+/// Each worker owns a contiguous range of task indices. A worker takes tasks from the
+/// front of its own range and, when that range is exhausted, steals the back half of the
+/// range of another worker. This keeps workers busy when task sizes are uneven without
+/// contending on a single shared queue.
+/// The calling thread participates as worker 0, so a pool with concurrency 1 runs
+/// all tasks on the calling thread.
+class work_stealing_pool
+{
+public:
+    explicit work_stealing_pool(std::size_t concurrency = default_concurrency())
+            : queues_(std::max<std::size_t>(concurrency, 1))
+    {
+        threads_.reserve(queues_.size() - 1);
+        for (std::size_t w = 1; w < queues_.size(); ++w) {
+            threads_.emplace_back([this, w] { worker_loop(w); });
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    static std::size_t default_concurrency() noexcept
+    { return std::max(std::thread::hardware_concurrency(), 1u); }
+
+    /// Number of workers including the calling thread.
+    std::size_t concurrency() const noexcept
+    { return queues_.size(); }
+
+    /// Invoke f(worker, index) for every index in [0, n) and block until all calls returned.
+    /// worker is smaller than concurrency() and identifies the worker running the task,
+    /// calls with the same worker index never run concurrently.
+    /// If a task throws, the remaining tasks are still run and the first exception is
+    /// rethrown in the calling thread.
+    template <typename F>
+        requires std::invocable<F&, std::size_t, std::size_t>
+    void for_each_index(std::size_t n, F&& f)
+    {
+        if (n == 0) return;
+        // one batch at a time
+        std::lock_guard run_lock(run_mutex_);
+
+        const auto workers = std::min(concurrency(), n);
+        for (std::size_t w = 0; w < concurrency(); ++w) {
+            auto& q = queues_[w];
+            std::lock_guard lock(q.mutex);
+            q.begin = w < workers ? w * n / workers : 0;
+            q.end = w < workers ? (w + 1) * n / workers : 0;
+        }
+
+        task_ = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        invoke_ = [](void* task, std::size_t worker, std::size_t index) {
+            (*static_cast<std::remove_reference_t<F>*>(task))(worker, index);
+        };
+        exception_ = nullptr;
+
+        {
+            std::lock_guard lock(mutex_);
+            active_workers_ = workers;
+            active_ = workers - 1;
+            ++generation_;
+        }
+        wake_cv_.notify_all();
+
+        run_tasks(0);
+
+        std::unique_lock lock(mutex_);
+        done_cv_.wait(lock, [this] { return active_ == 0; });
+
+        if (exception_) std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+
+private:
+    struct alignas(64) task_queue
+    {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    void worker_loop(std::size_t w)
+    {
+        std::size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_cv_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+                if (stop_) return;
+                seen_generation = generation_;
+                if (w >= active_workers_) continue;
+            }
+            run_tasks(w);
+            {
+                std::lock_guard lock(mutex_);
+                if (--active_ != 0) continue;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    void run_tasks(std::size_t w)
+    {
+        while (true) {
+            auto index = pop(w);
+            if (!index) index = steal(w);
+            if (!index) return;
+
+            try {
+                invoke_(task_, w, *index);
+            }
+            catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!exception_) exception_ = std::current_exception();
+            }
+        }
+    }
+
+    std::optional<std::size_t> pop(std::size_t w)
+    {
+        auto& q = queues_[w];
+        std::lock_guard lock(q.mutex);
+        if (q.begin == q.end) return std::nullopt;
+        return q.begin++;
+    }
+
+    /// Move the back half of the range of another worker to worker w and take a task from it.
+    std::optional<std::size_t> steal(std::size_t w)
+    {
+        const auto n = concurrency();
+        for (std::size_t i = 1; i < n; ++i) {
+            auto& victim = queues_[(w + i) % n];
+            std::size_t first, last;
+            {
+                std::lock_guard lock(victim.mutex);
+                const auto size = victim.end - victim.begin;
+                if (size == 0) continue;
+                last = victim.end;
+                first = last - (size + 1) / 2;
+                victim.end = first;
+            }
+            auto& q = queues_[w];
+            std::lock_guard lock(q.mutex);
+            q.begin = first + 1;
+            q.end = last;
+            return first;
+        }
+        return std::nullopt;
+    }
+
+    std::vector<task_queue> queues_;
+
+    // type erased task of the current batch
+    void* task_ = nullptr;
+    void (*invoke_)(void*, std::size_t, std::size_t) = nullptr;
+    std::exception_ptr exception_ {};
+
+    std::mutex run_mutex_ {};
+    std::mutex mutex_ {};
+    std::condition_variable wake_cv_ {};
+    std::condition_variable done_cv_ {};
+    std::size_t generation_ = 0;
+    std::size_t active_workers_ = 0;
+    std::size_t active_ = 0;
+    bool stop_ = false;
+
+    std::vector<std::thread> threads_ {};
+};
+
+} // namespace bencode
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "bencode/bview.hpp"
+#include "bencode/bvalue.hpp"
+#include "bencode/detail/diff.hpp"
@@ -0,0 +1,2 @@
+#pragma once
+#include "bencode/detail/events/encode_cbor_to.hpp"
@@ -0,0 +1,2 @@
+#pragma once
+#include "bencode/detail/events/encode_json_to.hpp"
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "bencode/bview.hpp"
+#include "bencode/detail/merge.hpp"
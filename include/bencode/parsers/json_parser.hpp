@@ -0,0 +1,3 @@
+#pragma once
+
+#include "bencode/detail/parser/json_parser.hpp"
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+#include "bencode/detail/parser/msgpack_parser.hpp"
@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/parsers/cbor_parser.hpp"
+#include "bencode/parsers/json_parser.hpp"
+#include "bencode/parsers/msgpack_parser.hpp"
+
+#include "../parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+using borrowed_bvalue = basic_bvalue<borrowed_bvalue_policy>;
+
+static bool points_into(std::string_view buffer, std::string_view s)
+{
+    return s.data() >= buffer.data() && s.data() + s.size() <= buffer.data() + buffer.size();
+}
+
+
+TEST_CASE("test decoding with borrowed_bvalue_policy")
+{
+    const std::string data(sintel_torrent);
+    auto value = decode_value<borrowed_bvalue_policy>(data);
+
+    SECTION("strings and keys refer to the input buffer") {
+        const auto& name = get_string(value["info"]["name"]);
+        CHECK(name == "Sintel");
+        CHECK(points_into(data, name));
+        CHECK(points_into(data, get_string(value["info"]["pieces"])));
+
+        for (const auto& [k, v] : get_dict(value["info"])) {
+            CHECK(points_into(data, k));
+        }
+    }
+
+    SECTION("round trip") {
+        CHECK(encode(value) == sintel_torrent);
+    }
+
+    SECTION("equal to value decoded with default policy") {
+        auto owned = decode_value(data);
+        CHECK(get_integer(value["info"]["piece length"]) == get_integer(owned["info"]["piece length"]));
+        CHECK(encode(value) == encode(owned));
+    }
+
+    SECTION("lists and dicts are mutable") {
+        auto& info = get_dict(value["info"]);
+        info.erase("pieces");
+        value["info"]["name"] = "Sintel 2"sv;
+        get_list(value["announce-list"]).clear();
+
+        CHECK_FALSE(value["info"].contains("pieces"));
+        CHECK(get_string(value["info"]["name"]) == "Sintel 2");
+        CHECK(get_list(value["announce-list"]).empty());
+    }
+}
+
+TEST_CASE("test borrowed_bvalue from bview")
+{
+    const std::string data(example);
+    auto table = decode_view(data);
+    auto root = table.get_root();
+
+    borrowed_bvalue value = root;
+
+    CHECK(encode(value) == data);
+    for (const auto& [k, v] : get_dict(value)) {
+        CHECK(points_into(data, k));
+    }
+    CHECK(get_integer(value["one"]) == 1);
+}
+
+TEST_CASE("test push_parser passes views into contiguous input")
+{
+    struct consumer : detail::discard_consumer
+    {
+        std::string_view buffer;
+        bool all_views = true;
+
+        void string(std::string_view s)
+        { all_views &= points_into(buffer, s); }
+
+        void error(const parsing_error&) {}
+    };
+
+    consumer c {};
+    c.buffer = example;
+    auto parser = push_parser();
+    REQUIRE(parser.parse(c, example));
+    CHECK(c.all_views);
+}
+
+template <typename Parser, typename Consumer>
+concept parser_accepts = requires(Parser p, Consumer c) { p.parse(c, std::string_view{}); };
+
+template <typename Policy, typename Arg>
+concept decodes_value_from = requires(Arg&& arg) { decode_value<Policy>(std::forward<Arg>(arg)); };
+
+TEST_CASE("test borrowing consumers require strings from the input")
+{
+    using borrowing = events::to_bvalue<borrowed_bvalue_policy>;
+    using owning = events::to_bvalue<>;
+
+    SECTION("producers") {
+        STATIC_REQUIRE(borrowing_event_consumer<borrowing>);
+        STATIC_REQUIRE_FALSE(borrowing_event_consumer<owning>);
+
+        STATIC_REQUIRE(parser_accepts<push_parser<>, borrowing>);
+        STATIC_REQUIRE(parser_accepts<msgpack_parser, borrowing>);
+        // json escape sequences and cbor indefinite length strings are decoded into a buffer
+        STATIC_REQUIRE_FALSE(parser_accepts<json_parser, borrowing>);
+        STATIC_REQUIRE_FALSE(parser_accepts<cbor_parser, borrowing>);
+        STATIC_REQUIRE(parser_accepts<json_parser, owning>);
+        STATIC_REQUIRE(parser_accepts<cbor_parser, owning>);
+    }
+
+    SECTION("decode_value") {
+        STATIC_REQUIRE(decodes_value_from<borrowed_bvalue_policy, const std::string&>);
+        STATIC_REQUIRE(decodes_value_from<borrowed_bvalue_policy, std::string_view>);
+        STATIC_REQUIRE_FALSE(decodes_value_from<borrowed_bvalue_policy, std::string>);
+        STATIC_REQUIRE(decodes_value_from<default_bvalue_policy, std::string>);
+    }
+
+    SECTION("strings from internal buffers are copied by owning consumers") {
+        auto json_consumer = owning {};
+        auto jparser = json_parser();
+        REQUIRE(jparser.parse(json_consumer, R"(["a\nb","c\td"])"));
+        CHECK(json_consumer.value() == bvalue(btype::list, {"a\nb", "c\td"}));
+
+        // two indefinite length text strings of two chunks each
+        constexpr auto cbor = "\x82\x7f\x61" "a" "\x61" "b" "\xff\x7f\x61" "c" "\x61" "d" "\xff"sv;
+        auto cbor_consumer = owning {};
+        auto cparser = cbor_parser();
+        REQUIRE(cparser.parse(cbor_consumer, cbor));
+        CHECK(cbor_consumer.value() == bvalue(btype::list, {"ab", "cd"}));
+    }
+}
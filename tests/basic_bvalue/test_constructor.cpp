@@ -9,6 +9,7 @@
 
 #include "bencode/traits/all.hpp"
 #include "bencode/bvalue.hpp"
+#include "bencode/encode.hpp"
 
 using namespace bencode;
 using namespace std::string_literals;
@@ -712,3 +713,47 @@ TEST_CASE("test initializer list constructor", "[constructor]")
     }
 }
 
+
+TEST_CASE("test copy and destruction of deeply nested values", "[construction]")
+{
+    constexpr std::size_t depth = 50000;
+
+    auto make_nested = [&]() {
+        auto value = bvalue(1);
+        for (std::size_t i = 0; i < depth; ++i) {
+            if (i % 2 == 0) {
+                auto outer = bvalue(btype::list);
+                get_list(outer).push_back("a");
+                get_list(outer).push_back(std::move(value));
+                value = std::move(outer);
+            }
+            else {
+                auto outer = bvalue(btype::dict);
+                get_dict(outer).emplace("a", std::move(value));
+                get_dict(outer).emplace("b", 2);
+                value = std::move(outer);
+            }
+        }
+        return value;
+    };
+
+    auto value = make_nested();
+    const auto expected = encode(value);
+
+    // sections are not used to build the nested value only once
+    auto copy = value;
+    CHECK(encode(copy) == expected);
+
+    copy = bvalue(btype::list);
+    copy = value;
+    CHECK(encode(copy) == expected);
+
+    // outermost value is d1:a<inner>1:bi2ee
+    const bvalue inner = value["a"];
+    CHECK(encode(inner) == expected.substr(4, expected.size() - 11));
+    value = value["a"];
+    CHECK(encode(value) == encode(inner));
+
+    copy.discard();
+    CHECK(copy.type() == bencode_type::uninitialized);
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <map>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/decode_batch.hpp"
+
+#include "../parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+using interned_bvalue = basic_bvalue<interning_bvalue_policy>;
+
+
+TEST_CASE("test key_pool")
+{
+    key_pool pool {};
+    const auto& a = pool.intern("length");
+    const auto& b = pool.intern(std::string("length"));
+    const auto& c = pool.intern("path");
+
+    CHECK(&a == &b);
+    CHECK(&a != &c);
+    CHECK(a == "length");
+    CHECK(pool.size() == 2);
+    CHECK(pool.string_bytes() == 10);
+
+    SECTION("clear releases all strings") {
+        pool.clear();
+        CHECK(pool.size() == 0);
+        CHECK(pool.string_bytes() == 0);
+        CHECK(pool.intern("path") == "path");
+        CHECK(pool.size() == 1);
+    }
+}
+
+TEST_CASE("test key_pool scope")
+{
+    const auto data = "ld6:lengthi1e4:pathl1:aeed6:lengthi2e4:pathl1:beee"sv;
+    key_pool pool {};
+
+    CHECK(&key_pool::current() == &key_pool::global());
+    {
+        key_pool::scope s(pool);
+        CHECK(&key_pool::current() == &pool);
+        {
+            key_pool inner {};
+            key_pool::scope s2(inner);
+            CHECK(&key_pool::current() == &inner);
+        }
+        CHECK(&key_pool::current() == &pool);
+
+        auto value = decode_value<interning_bvalue_policy>(data);
+        CHECK(pool.size() == 2);
+        CHECK(&get_dict(get_list(value)[0]).begin()->first.pooled() == &pool.intern("length"));
+    }
+    CHECK(&key_pool::current() == &key_pool::global());
+
+    SECTION("batch workers use the pool of the calling thread") {
+        key_pool batch_pool {};
+        key_pool::scope s(batch_pool);
+        const std::string_view inputs[] = {data, "d3:fooi1ee"sv, "d3:bari2ee"sv};
+        auto results = decode_value_batch<interning_bvalue_policy>(inputs);
+        REQUIRE(results.size() == 3);
+        CHECK(results[1].value().contains("foo"));
+        CHECK(batch_pool.size() == 4);
+    }
+}
+
+TEST_CASE("test interned_string")
+{
+    key_pool pool {};
+    auto a = interned_string(pool, "path");
+    auto b = interned_string(pool, "path"sv);
+    auto c = interned_string(pool, "length");
+
+    SECTION("equal strings share storage") {
+        CHECK(&a.pooled() == &b.pooled());
+        CHECK(a.data() == b.data());
+        CHECK(a == b);
+    }
+    SECTION("lexicographical ordering") {
+        CHECK(c < a);
+        CHECK(a > c);
+        CHECK(a != c);
+    }
+    SECTION("comparison with other string types") {
+        CHECK(a == "path");
+        CHECK(a == "path"sv);
+        CHECK(a == std::string("path"));
+        CHECK(a < "zzz"sv);
+        CHECK(a > std::string("a"));
+    }
+    SECTION("strings from different pools compare equal") {
+        auto g = interned_string("path");
+        CHECK(&g.pooled() != &a.pooled());
+        CHECK(g == a);
+        CHECK((g <=> a) == std::strong_ordering::equal);
+    }
+    SECTION("default constructed") {
+        interned_string e {};
+        CHECK(e.empty());
+        CHECK(e.size() == 0);
+        CHECK(e == ""sv);
+    }
+    SECTION("hash") {
+        CHECK(std::hash<interned_string>{}(a) == std::hash<std::string_view>{}("path"));
+    }
+}
+
+TEST_CASE("test decoding with interning_bvalue_policy")
+{
+    const auto data = "ld6:lengthi1e4:pathl1:aee"
+                      "d6:lengthi2e4:pathl1:bee"
+                      "d6:lengthi3e4:pathl6:lengthee"
+                      "e"sv;
+
+    auto value = decode_value<interning_bvalue_policy>(data);
+    auto& files = get_list(value);
+    REQUIRE(files.size() == 3);
+
+    SECTION("repeated keys share storage") {
+        const auto& first = get_dict(files[0]);
+        const auto& second = get_dict(files[1]);
+        CHECK(first.begin()->first.data() == second.begin()->first.data());
+        CHECK(std::next(first.begin())->first.data() == std::next(second.begin())->first.data());
+    }
+
+    SECTION("string values are not interned") {
+        const auto& path = get_list(files[2].at("path"));
+        CHECK(get_string(path[0]) == "length");
+        CHECK(get_string(path[0]).data() != get_dict(files[2]).begin()->first.data());
+    }
+
+    SECTION("lookup by key") {
+        CHECK(get_integer(files[0]["length"]) == 1);
+        CHECK(get_integer(files[1].at("length")) == 2);
+        CHECK(files[2].contains("path"));
+        CHECK_FALSE(files[2].contains("md5sum"));
+    }
+
+    SECTION("round trip") {
+        CHECK(encode(value) == data);
+    }
+
+    SECTION("equal to value decoded with default policy") {
+        auto sintel = decode_value<interning_bvalue_policy>(sintel_torrent);
+        CHECK(encode(sintel) == sintel_torrent);
+        CHECK(get_string(sintel["info"]["name"]) == "Sintel");
+        CHECK(get_integer(sintel["info"]["piece length"]) == 131072);
+    }
+
+    SECTION("conversion") {
+        auto d = decode_value<interning_bvalue_policy>("d1:ai1e1:bi2ee"sv);
+        auto m = get_as<std::map<std::string, int>>(d);
+        CHECK(m == std::map<std::string, int>{{"a", 1}, {"b", 2}});
+    }
+}
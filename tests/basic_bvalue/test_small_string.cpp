@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <utility>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+
+#include "../parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+using small_bvalue = basic_bvalue<small_string_bvalue_policy>;
+
+
+TEST_CASE("test small_string")
+{
+    const auto sha1 = std::string(20, 'a');
+    const auto sha256 = std::string(32, 'b');
+    const auto large = std::string(100, 'c');
+
+    SECTION("construction") {
+        CHECK(small_string().empty());
+        CHECK(small_string().is_inline());
+        CHECK(small_string("abc") == "abc");
+        CHECK(small_string("abcdef", 3) == "abc"sv);
+        CHECK(small_string(3, 'x') == "xxx");
+        CHECK(small_string({'a', 'b'}) == "ab");
+        CHECK(small_string(sha1.begin(), sha1.end()) == sha1);
+        CHECK(*small_string("abc").c_str() == 'a');
+        CHECK(small_string("abc").c_str()[3] == '\0');
+    }
+
+    SECTION("hash sized strings are stored inline") {
+        auto a = small_string(sha1);
+        auto b = small_string(sha256);
+        CHECK(a.is_inline());
+        CHECK(b.is_inline());
+        CHECK(b.capacity() == 32);
+        CHECK(a == sha1);
+        CHECK(b == sha256);
+    }
+
+    SECTION("large strings are stored on the heap") {
+        auto c = small_string(large);
+        CHECK_FALSE(c.is_inline());
+        CHECK(c.capacity() == large.size());
+        CHECK(c == large);
+        CHECK(c.c_str()[large.size()] == '\0');
+    }
+
+    SECTION("copy and move") {
+        for (const auto& s : {sha1, large}) {
+            auto a = small_string(s);
+            auto b = a;
+            CHECK(b == a);
+            auto c = std::move(a);
+            CHECK(c == s);
+            CHECK(a.empty());
+            CHECK(a.is_inline());
+            a = c;
+            CHECK(a == s);
+            b = std::move(c);
+            CHECK(b == s);
+            a = std::move(a);
+            CHECK(a == s);
+        }
+    }
+
+    SECTION("growth") {
+        small_string s {};
+        for (int i = 0; i < 40; ++i) s.push_back('a' + i % 26);
+        CHECK(s.size() == 40);
+        CHECK_FALSE(s.is_inline());
+        CHECK(s.front() == 'a');
+        CHECK(s.back() == 'n');
+
+        s.resize(10);
+        CHECK(s.size() == 10);
+        s.shrink_to_fit();
+        CHECK(s.is_inline());
+        CHECK(s == "abcdefghij");
+
+        s.append(s);
+        CHECK(s == "abcdefghijabcdefghij");
+        s += std::string_view(large);
+        CHECK(s.size() == 120);
+        s.assign(std::string_view(s).substr(5, 5));
+        CHECK(s == "fghij");
+        s.clear();
+        CHECK(s.empty());
+    }
+
+    SECTION("swap") {
+        auto a = small_string("short");
+        auto b = small_string(large);
+        swap(a, b);
+        CHECK(a == large);
+        CHECK(b == "short");
+    }
+
+    SECTION("comparison") {
+        auto a = small_string("abc");
+        CHECK(a == small_string("abc"));
+        CHECK(a < small_string("abd"));
+        CHECK(a < "b");
+        CHECK(a > "ab"sv);
+        CHECK(a != std::string("abd"));
+        CHECK(std::hash<small_string>{}(a) == std::hash<std::string_view>{}("abc"));
+    }
+
+    SECTION("at") {
+        auto a = small_string("abc");
+        CHECK(a.at(2) == 'c');
+        CHECK_THROWS_AS(a.at(3), std::out_of_range);
+    }
+}
+
+TEST_CASE("test decoding with small_string_bvalue_policy")
+{
+    auto value = decode_value<small_string_bvalue_policy>(sintel_torrent);
+
+    CHECK(encode(value) == sintel_torrent);
+    CHECK(get_string(value["info"]["name"]) == "Sintel");
+    CHECK(get_integer(value["info"]["piece length"]) == 131072);
+    CHECK(value["info"].contains("pieces"));
+    CHECK(value["info"]["name"] == "Sintel");
+    CHECK(get_as<std::string>(value["info"]["name"]) == "Sintel");
+
+    SECTION("hash sized values do not allocate") {
+        auto v = decode_value<small_string_bvalue_policy>("20:aaaaaaaaaaaaaaaaaaaa"sv);
+        CHECK(get_string(v).is_inline());
+        CHECK(v.memory_usage().heap_bytes == 0);
+    }
+
+    SECTION("construction and assignment") {
+        small_bvalue b = "abc";
+        CHECK(get_string(b) == "abc");
+        b = std::string_view("def");
+        CHECK(get_string(b) == "def");
+        auto d = small_bvalue(btype::dict);
+        d["key"] = 1;
+        CHECK(get_integer(d.at("key")) == 1);
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bview.hpp"
+
+using namespace std::string_view_literals;
+namespace bc = bencode;
+
+
+TEST_CASE("test canonical flag of parsed bviews", "[bview][comparison]")
+{
+    SECTION("sorted keys") {
+        auto t = bc::decode_view("d1:ai1e1:bli1ei2eee"sv);
+        auto root = t.get_root();
+        CHECK(root.is_canonical());
+        CHECK(get_dict(root).at("b").is_canonical());
+        CHECK(get_dict(root).at("a").is_canonical());
+    }
+    SECTION("unsorted keys in a nested dict") {
+        auto t = bc::decode_view("d1:ad1:bi1e1:ai2ee1:bd1:ai1eee"sv);
+        auto root = t.get_root();
+        CHECK_FALSE(root.is_canonical());
+        CHECK_FALSE(get_dict(root).at("a").is_canonical());
+        CHECK(get_dict(root).at("b").is_canonical());
+    }
+    SECTION("duplicate keys") {
+        auto t = bc::decode_view("d1:ai1e1:ai1ee"sv);
+        CHECK_FALSE(t.get_root().is_canonical());
+    }
+    SECTION("empty and uninitialized") {
+        auto t = bc::decode_view("le"sv);
+        CHECK(t.get_root().is_canonical());
+        CHECK_FALSE(bc::bview{}.is_canonical());
+    }
+    SECTION("integers and string lengths with leading zeros are rejected") {
+        auto t = bc::decode_view("li0e0:e"sv);
+        CHECK(t.get_root().is_canonical());
+        CHECK(get_list(t.get_root()).front().is_canonical());
+
+        CHECK_THROWS_AS(bc::decode_view("li00ee"sv), bc::parsing_error);
+        CHECK_THROWS_AS(bc::decode_view("l00:e"sv), bc::parsing_error);
+        CHECK_THROWS_AS(bc::decode_view("l01:ae"sv), bc::parsing_error);
+    }
+}
+
+TEST_CASE("test comparison of bviews", "[bview][comparison]")
+{
+    // separate buffers so equal values never share descriptors
+    const std::string a = "d1:ad1:xi1e1:yli1ei2eee1:bi10ee";
+    const std::string b = a;
+    const std::string c = "d1:ad1:xi1e1:yli1ei3eee1:bi10ee";
+    const std::string d = "d1:ad1:xi1e1:yli1ei2eee1:bi9ee";
+
+    auto ta = bc::decode_view(a);
+    auto tb = bc::decode_view(b);
+    auto tc = bc::decode_view(c);
+    auto td = bc::decode_view(d);
+
+    SECTION("canonical values") {
+        CHECK(ta.get_root() == tb.get_root());
+        CHECK(ta.get_root() != tc.get_root());
+        CHECK((ta.get_root() <=> tb.get_root()) == std::weak_ordering::equivalent);
+        CHECK((ta.get_root() <=> tc.get_root()) == std::weak_ordering::less);
+        // integers are ordered by value, not by their bencoded representation
+        CHECK((ta.get_root() <=> td.get_root()) == std::weak_ordering::greater);
+    }
+
+    SECTION("canonical subtrees of values with unsorted keys") {
+        const std::string e = "d1:bi10e1:ad1:xi1e1:yli1ei2eeee";
+        const std::string f = "d1:bi10e1:ad1:xi1e1:yli1ei3eeee";
+        auto te = bc::decode_view(e);
+        auto tf = bc::decode_view(f);
+        REQUIRE_FALSE(te.get_root().is_canonical());
+
+        CHECK(te.get_root() == bc::decode_view(std::string(e)).get_root());
+        CHECK(te.get_root() != tf.get_root());
+        CHECK(get_dict(te.get_root()).at("a") == get_dict(ta.get_root()).at("a"));
+        CHECK((te.get_root() <=> tf.get_root()) == std::weak_ordering::less);
+    }
+
+    SECTION("list_bview and dict_bview") {
+        CHECK(get_dict(ta.get_root()) == get_dict(tb.get_root()));
+
+        const auto& ya = get_list(get_dict(get_dict(ta.get_root()).at("a")).at("y"));
+        const auto& yc = get_list(get_dict(get_dict(tc.get_root()).at("a")).at("y"));
+        CHECK(ya != yc);
+        CHECK((ya <=> yc) == std::weak_ordering::less);
+    }
+}
+
+TEST_CASE("test comparison of bviews with other types", "[bview][comparison]")
+{
+    auto t = bc::decode_view("l3:abci2eli1ei2eee"sv);
+    auto l = get_list(t.get_root());
+
+    CHECK(l[0] == "abc"sv);
+    CHECK(l[0] == std::string("abc"));
+    CHECK(l[0] != "abd"sv);
+    CHECK(l[1] != "abc"sv);
+    CHECK(l[2] == std::vector{1, 2});
+    CHECK((l[2] <=> std::vector{1, 3}) == std::weak_ordering::less);
+    CHECK((l[0] <=> std::vector{1, 3}) == std::weak_ordering::less);
+}
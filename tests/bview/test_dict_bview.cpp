@@ -2,6 +2,7 @@
 
 #include "bencode/bview.hpp"
 
+#include <array>
 #include <type_traits>
 #include <string>
 #include <string_view>
@@ -81,6 +82,28 @@ TEST_CASE("test dict_bview") {
         CHECK(dict.contains("spam"));
         CHECK_FALSE(dict.contains("bar"));
     }
+    SECTION("find_many()") {
+        const std::array<std::string_view, 3> keys {"bar", "eggs", "spam"};
+        std::array<bc::bview, 3> out {};
+
+        dict.find_many(keys, out);
+        CHECK(is_uninitialized(out[0]));
+        CHECK(is_uninitialized(out[1]));
+        CHECK(out[2] == 1);
+
+        // unsorted keys
+        nested_dict.find_many(keys, out);
+        CHECK(get_list(out[0]).size() == 2);
+        CHECK(is_uninitialized(out[1]));
+        CHECK(out[2] == 1);
+
+        const auto values = nested_dict.find_many(keys);
+        CHECK(std::equal(values.begin(), values.end(), out.begin(), out.end()));
+    }
+    SECTION("has_sorted_keys") {
+        CHECK(dict.has_sorted_keys());
+        CHECK_FALSE(nested_dict.has_sorted_keys());
+    }
     SECTION("equal_range") {
         SECTION("found") {
             auto[first, last] = dict.equal_range("spam");
@@ -143,6 +166,26 @@ TEST_CASE("test dict_bview") {
     }
 }
 
+TEST_CASE("test dict_bview find_many with sorted keys") {
+    constexpr std::string_view data = "d1:ai1e1:bi2e1:di4e1:fi6ee";
+    auto table = bc::decode_view(data);
+    const auto& d = get_dict(table.get_root());
+    REQUIRE(d.has_sorted_keys());
+
+    const std::array<std::string_view, 6> keys {"0", "a", "c", "d", "d", "z"};
+    std::array<bc::bview, 6> out {};
+    d.find_many(keys, out);
+
+    CHECK(is_uninitialized(out[0]));
+    CHECK(out[1] == 1);
+    CHECK(is_uninitialized(out[2]));
+    CHECK(out[3] == 4);
+    CHECK(out[4] == 4);
+    CHECK(is_uninitialized(out[5]));
+
+    CHECK(d.find_many({}).empty());
+}
+
 
 //constexpr std::string_view example = (
 //        "d"
@@ -67,10 +67,10 @@ TEST_CASE("test string_bview") {
         CHECK(string.length() == 4);
     }
     SECTION("max_size()") {
-        CHECK(string.max_size() == std::numeric_limits<std::uint32_t>::max());
+        CHECK(string.max_size() == bencode::descriptor::max_string_size);
     }
     SECTION("max_size()") {
-        CHECK(string.max_size() == std::numeric_limits<std::uint32_t>::max());
+        CHECK(string.max_size() == bencode::descriptor::max_string_size);
     }
 
     SECTION("iterators") {
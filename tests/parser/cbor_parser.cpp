@@ -0,0 +1,82 @@
+#include <bencode/bencode.hpp>
+#include <bencode/parsers/cbor_parser.hpp>
+#include <bencode/traits/all.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+static std::string cbor_to_bencode(std::string_view cbor)
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = cbor_parser();
+    REQUIRE(parser.parse(consumer, cbor));
+    return out;
+}
+
+static parsing_errc cbor_error(std::string_view cbor, const parser_options& options = {})
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = cbor_parser(options);
+    REQUIRE_FALSE(parser.parse(consumer, cbor));
+    REQUIRE(parser.has_error());
+    return parser.error().errc();
+}
+
+TEST_CASE("test cbor parser")
+{
+    SECTION("integers") {
+        CHECK(cbor_to_bencode("\x00"sv) == "i0e");
+        CHECK(cbor_to_bencode("\x18\x64"sv) == "i100e");
+        CHECK(cbor_to_bencode("\x39\x01\x00"sv) == "i-257e");
+        CHECK(cbor_to_bencode("\x3b\x7f\xff\xff\xff\xff\xff\xff\xff"sv) == "i-9223372036854775808e");
+        CHECK(cbor_to_bencode("\xf4\xf5"sv) == "i0ei1e");
+    }
+
+    SECTION("strings") {
+        CHECK(cbor_to_bencode("\x64spam"sv) == "4:spam");
+        CHECK(cbor_to_bencode("\x42\xff\x00"sv) == "2:\xff\x00"sv);
+        // indefinite length string with two chunks
+        CHECK(cbor_to_bencode("\x7f\x62sp\x62\x61m\xff"sv) == "4:spam");
+    }
+
+    SECTION("tags are ignored") {
+        CHECK(cbor_to_bencode("\xc0\x61x"sv) == "1:x");
+    }
+
+    SECTION("lists") {
+        CHECK(cbor_to_bencode("\x80"sv) == "le");
+        CHECK(cbor_to_bencode("\x82\x01\x81\x02"sv) == "li1eli2eee");
+        CHECK(cbor_to_bencode("\x9f\x01\x9f\xff\xff"sv) == "li1elee");
+    }
+
+    SECTION("dict keys are sorted") {
+        CHECK(cbor_to_bencode("\xa2\x61" "b\x01\x61" "a\x82\x02\x03"sv) == "d1:ali2ei3ee1:bi1ee");
+        CHECK(cbor_to_bencode("\xbf\x61" "b\xa0\x7f\x61" "a\xff\x9f\xff\xff"sv) == "d1:ale1:bdee");
+        CHECK(cbor_to_bencode("\xa2\x61" "b\xa2\x61" "y\x01\x61" "x\x02\x61" "a\x81\xa1\x7f\x61" "z\xff\x03"sv)
+              == "d1:ald1:zi3eee1:bd1:xi2e1:yi1eee");
+        // chunked keys of successive data items
+        CHECK(cbor_to_bencode("\xa1\x7f\x61" "k\xff\x01\xa1\x7f\x61" "j\xff\x02"sv) == "d1:ki1eed1:ji2ee");
+    }
+
+    SECTION("errors") {
+        CHECK(cbor_error("\xf6"sv) == parsing_errc::unsupported_cbor_value);
+        CHECK(cbor_error("\xfb\x3f\xf0\x00\x00\x00\x00\x00\x00"sv) == parsing_errc::unsupported_cbor_value);
+        CHECK(cbor_error("\x1b\x80\x00\x00\x00\x00\x00\x00\x00"sv) == parsing_errc::integer_overflow);
+        CHECK(cbor_error("\x1c"sv) == parsing_errc::invalid_cbor_item);
+        CHECK(cbor_error("\xff"sv) == parsing_errc::invalid_cbor_item);
+        CHECK(cbor_error("\x81\xff"sv) == parsing_errc::invalid_cbor_item);
+        CHECK(cbor_error("\x7f\x41x\xff"sv) == parsing_errc::invalid_cbor_item);
+        CHECK(cbor_error("\x64sp"sv) == parsing_errc::unexpected_eof);
+        CHECK(cbor_error("\x9b\xff\xff\xff\xff\xff\xff\xff\xff"sv) == parsing_errc::unexpected_eof);
+        CHECK(cbor_error("\xa1\x01\x01"sv) == parsing_errc::expected_string_dict_key);
+        CHECK(cbor_error("\xa2\x61" "a\x01\x61" "a\x02"sv) == parsing_errc::duplicate_dict_key);
+        CHECK(cbor_error("\x81\x81\x81\x80"sv, {.recursion_limit = 2}) == parsing_errc::recursion_depth_exceeded);
+        CHECK(cbor_error("\x83\x01\x02\x03"sv, {.value_limit = 3}) == parsing_errc::value_limit_exceeded);
+    }
+}
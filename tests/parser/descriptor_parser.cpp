@@ -8,6 +8,10 @@
 #include <string_view>
 #include <sstream>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #include "data.hpp"
 
 using namespace std::string_view_literals;
@@ -170,3 +174,63 @@ TEST_CASE("descriptor parser - example, sintel")
     bencode::connect(consumer, desc);
     CHECK(out == expected);
 }
+
+
+TEST_CASE("descriptor - positions and sizes larger than 4 GiB")
+{
+    constexpr std::uint64_t position = (std::uint64_t(1) << 40) + 7;
+    constexpr std::uint64_t size = (std::uint64_t(5) << 30) + 3;
+
+    static_assert(sizeof(descriptor) == 16);
+
+    constexpr auto d = descriptor(descriptor_type::string, position, 11, size);
+    STATIC_REQUIRE(d.position() == position);
+    STATIC_REQUIRE(d.offset() == 11);
+    STATIC_REQUIRE(d.size() == size);
+
+    auto t = descriptor(descriptor_type::string, descriptor::max_position);
+    t.set_size(descriptor::max_string_size);
+    CHECK(t.position() == descriptor::max_position);
+    CHECK(t.size() == descriptor::max_string_size);
+    CHECK(t != d);
+}
+
+#if defined(__linux__)
+TEST_CASE("descriptor parser - input larger than 4 GiB")
+{
+    // untouched pages of the string contents are never backed by memory
+    constexpr std::size_t string_size = (std::size_t(5) << 30);
+    constexpr std::string_view prefix = "l5368709120:";
+    constexpr std::string_view suffix = "i1ee";
+    const std::size_t total_size = prefix.size() + string_size + suffix.size();
+
+    void* addr = mmap(nullptr, total_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (addr == MAP_FAILED) {
+        WARN("could not map 5 GiB of address space");
+        return;
+    }
+    auto* data = static_cast<char*>(addr);
+    std::copy(prefix.begin(), prefix.end(), data);
+    std::copy(suffix.begin(), suffix.end(), data + prefix.size() + string_size);
+
+    auto parser = descriptor_parser();
+    auto r = parser.parse(std::string_view(data, total_size));
+    REQUIRE(r);
+
+    const auto& descriptors = r->descriptors();
+    REQUIRE(descriptors.size() == 4);
+    CHECK(descriptors[1].is_string());
+    CHECK(descriptors[1].size() == string_size);
+    CHECK(descriptors[2].is_integer());
+    CHECK(descriptors[2].position() == prefix.size() + string_size);
+
+    auto root = r->get_root();
+    const auto& l = get_list(root);
+    CHECK(get_string(l[0]).size() == string_size);
+    CHECK(get_integer(l[1]) == 1);
+    CHECK(l.bencoded_view().size() == total_size);
+
+    munmap(addr, total_size);
+}
+#endif
@@ -0,0 +1,88 @@
+#include <bencode/bview.hpp>
+#include <bencode/parsers/push_parser.hpp>
+#include <bencode/parsers/descriptor_parser.hpp>
+#include <catch2/catch.hpp>
+
+#include "data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+namespace {
+
+struct discard_consumer
+{
+    void integer(std::int64_t) {}
+    void string(std::string_view) {}
+    void begin_list(std::optional<std::size_t> = std::nullopt) {}
+    void end_list(std::optional<std::size_t> = std::nullopt) {}
+    void begin_dict(std::optional<std::size_t> = std::nullopt) {}
+    void end_dict(std::optional<std::size_t> = std::nullopt) {}
+    void list_item() {}
+    void dict_key() {}
+    void dict_value() {}
+    void error(const parsing_error&) {}
+};
+
+}
+
+static_assert(sizeof(push_parser<>) == sizeof(push_parser<const char*, const char*, no_instrumentation>));
+
+template <typename Parser>
+static const parser_stats& parse_and_get_stats(Parser& parser, std::string_view data)
+{
+    if constexpr (requires { parser.parse(data); }) {
+        (void) parser.parse(data);
+    }
+    else {
+        discard_consumer consumer {};
+        (void) parser.parse(consumer, data);
+    }
+    return parser.instrumentation().stats();
+}
+
+TEMPLATE_TEST_CASE("test parser instrumentation", "",
+                   (push_parser<const char*, const char*, stats_instrumentation>),
+                   (descriptor_parser<const char*, const char*, stats_instrumentation>))
+{
+    auto parser = TestType();
+
+    SECTION("token counts") {
+        // d 3:one i1e 5:three l d 3:bar i0e 3:foo i0e e e 3:two l i3e 3:foo i4e e e
+        const auto& stats = parse_and_get_stats(parser, example);
+        CHECK(stats.parse_count == 1);
+        CHECK(stats.bytes_processed == example.size());
+        CHECK(stats.integer_count == 5);
+        CHECK(stats.string_count == 6);
+        CHECK(stats.list_count == 2);
+        CHECK(stats.dict_count == 2);
+        CHECK(stats.token_count() == 15);
+        CHECK(stats.max_depth == 3);
+        CHECK(stats.string_bytes == 3 + 5 + 3 + 3 + 3 + 3);
+        CHECK(stats.framing_bytes() == example.size() - stats.string_bytes);
+        CHECK(stats.error_count() == 0);
+    }
+
+    SECTION("counters accumulate until reset") {
+        (void) parse_and_get_stats(parser, example);
+        const auto& stats = parse_and_get_stats(parser, sintel_torrent);
+        CHECK(stats.parse_count == 2);
+        CHECK(stats.bytes_processed == example.size() + sintel_torrent.size());
+        CHECK(stats.parse_time.count() >= 0);
+
+        parser.instrumentation().reset();
+        CHECK(parser.instrumentation().stats().parse_count == 0);
+        CHECK(parser.instrumentation().stats().bytes_processed == 0);
+    }
+
+    SECTION("error mix") {
+        (void) parse_and_get_stats(parser, "i01e"sv);
+        (void) parse_and_get_stats(parser, "li1e"sv);
+        (void) parse_and_get_stats(parser, "i02e"sv);
+        const auto& stats = parse_and_get_stats(parser, "i1e"sv);
+        CHECK(stats.parse_count == 4);
+        CHECK(stats.error_count() == 3);
+        CHECK(stats.error_count(parsing_errc::leading_zero) == 2);
+        CHECK(stats.error_count(parsing_errc::expected_list_value_or_end) == 1);
+    }
+}
@@ -0,0 +1,107 @@
+#include <bencode/bencode.hpp>
+#include <bencode/events/encode_json_to.hpp>
+#include <bencode/parsers/json_parser.hpp>
+#include <bencode/traits/all.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+static std::string json_to_bencode(std::string_view json)
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = json_parser();
+    REQUIRE(parser.parse(consumer, json));
+    return out;
+}
+
+static parsing_errc json_error(std::string_view json, const parser_options& options = {})
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = json_parser(options);
+    REQUIRE_FALSE(parser.parse(consumer, json));
+    REQUIRE(parser.has_error());
+    return parser.error().errc();
+}
+
+TEST_CASE("test json parser")
+{
+    SECTION("scalars") {
+        CHECK(json_to_bencode("42") == "i42e");
+        CHECK(json_to_bencode("-7") == "i-7e");
+        CHECK(json_to_bencode(R"("spam")") == "4:spam");
+        CHECK(json_to_bencode(R"("\u0001")") == "1:\x01");
+        CHECK(json_to_bencode("true") == "i1e");
+        CHECK(json_to_bencode("false") == "i0e");
+    }
+
+    SECTION("structures") {
+        CHECK(json_to_bencode("[]") == "le");
+        CHECK(json_to_bencode("{}") == "de");
+        CHECK(json_to_bencode(" [ 1 , [ 2 ] , { } ] ") == "li1eli2eedee");
+    }
+
+    SECTION("dict keys are sorted") {
+        CHECK(json_to_bencode(R"({"b": 1, "a": [3, {"z": 1, "y": "x"}], "c": {}})")
+              == "d1:ali3ed1:y1:x1:zi1eee1:bi1e1:cdee");
+        CHECK(json_to_bencode(R"([{"d": {"f": 1, "e\n": [{"h": 2, "g": 3}]}, "c": "\t"}, {"b": 4, "a": 5}])")
+              == "ld1:c1:\t1:dd2:e\nld1:gi3e1:hi2eee1:fi1eeed1:ai5e1:bi4eee");
+    }
+
+    SECTION("escape sequences") {
+        CHECK(json_to_bencode(R"("a\"b\\c\/d\n\u00e9\ud83d\ude00")")
+              == "14:a\"b\\c/d\n\xc3\xa9\xf0\x9f\x98\x80");
+        CHECK(json_to_bencode(R"("a longer string without escapes \t and a tail")")
+              == "44:a longer string without escapes \t and a tail");
+        CHECK(json_to_bencode(R"({"kb": 1, "ka": 2})") == "d2:kai2e2:kbi1ee");
+    }
+
+    SECTION("successive values") {
+        CHECK(json_to_bencode("1 2\n[3]") == "i1ei2eli3ee");
+    }
+
+    SECTION("round trip through encode_json_to") {
+        std::string json {};
+        auto json_consumer = events::encode_json_to(json);
+        auto bparser = push_parser();
+        REQUIRE(bparser.parse(json_consumer, example));
+        CHECK(json_to_bencode(json) == example);
+    }
+
+    SECTION("build bvalue") {
+        auto consumer = events::to_bvalue();
+        auto parser = json_parser();
+        REQUIRE(parser.parse(consumer, R"({"b": [1, "two"], "a": 1})"));
+        auto b = consumer.value();
+        CHECK(b == bvalue{{"a", 1}, {"b", bvalue(btype::list, {1, "two"})}});
+    }
+
+    SECTION("errors") {
+        CHECK(json_error("null") == parsing_errc::unsupported_json_value);
+        CHECK(json_error("1.5") == parsing_errc::unsupported_json_value);
+        CHECK(json_error("1e3") == parsing_errc::unsupported_json_value);
+        CHECK(json_error(R"({"a": 1, "a": 2})") == parsing_errc::duplicate_dict_key);
+        CHECK(json_error("[1,]") == parsing_errc::expected_json_value);
+        CHECK(json_error("[1 2]") == parsing_errc::expected_json_comma_or_end);
+        CHECK(json_error(R"({"a" 1})") == parsing_errc::expected_json_colon);
+        CHECK(json_error(R"({1: 1})") == parsing_errc::expected_json_string);
+        CHECK(json_error(R"({"a": 1x})") == parsing_errc::expected_json_comma_or_end);
+        CHECK(json_error(R"({"a": [1)") == parsing_errc::unexpected_eof);
+        CHECK(json_error(R"({"a": [1})") == parsing_errc::expected_json_comma_or_end);
+        CHECK(json_error(R"("abc)") == parsing_errc::unexpected_eof);
+        CHECK(json_error(R"("\x")") == parsing_errc::invalid_json_escape);
+        CHECK(json_error(R"("\udc00")") == parsing_errc::invalid_json_escape);
+        CHECK(json_error("\"a\nb\"") == parsing_errc::expected_json_string);
+        CHECK(json_error("\"\\n\x01\"") == parsing_errc::expected_json_string);
+        CHECK(json_error("\"0123456789abcdef\tx\"") == parsing_errc::expected_json_string);
+        CHECK(json_error("tru") == parsing_errc::invalid_json_literal);
+        CHECK(json_error("?") == parsing_errc::expected_json_value);
+        CHECK(json_error("[[[[[[]]]]]]", {.recursion_limit = 4}) == parsing_errc::recursion_depth_exceeded);
+        CHECK(json_error("[1,2,3,4]", {.value_limit = 3}) == parsing_errc::value_limit_exceeded);
+    }
+}
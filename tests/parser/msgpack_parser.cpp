@@ -0,0 +1,69 @@
+#include <bencode/bencode.hpp>
+#include <bencode/parsers/msgpack_parser.hpp>
+#include <bencode/traits/all.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+static std::string msgpack_to_bencode(std::string_view msgpack)
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = msgpack_parser();
+    REQUIRE(parser.parse(consumer, msgpack));
+    return out;
+}
+
+static parsing_errc msgpack_error(std::string_view msgpack, const parser_options& options = {})
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = msgpack_parser(options);
+    REQUIRE_FALSE(parser.parse(consumer, msgpack));
+    REQUIRE(parser.has_error());
+    return parser.error().errc();
+}
+
+TEST_CASE("test msgpack parser")
+{
+    SECTION("integers") {
+        CHECK(msgpack_to_bencode("\x7f"sv) == "i127e");
+        CHECK(msgpack_to_bencode("\xe0"sv) == "i-32e");
+        CHECK(msgpack_to_bencode("\xcd\x01\x00"sv) == "i256e");
+        CHECK(msgpack_to_bencode("\xd1\xff\x7f"sv) == "i-129e");
+        CHECK(msgpack_to_bencode("\xd3\x80\x00\x00\x00\x00\x00\x00\x00"sv) == "i-9223372036854775808e");
+        CHECK(msgpack_to_bencode("\xc2\xc3"sv) == "i0ei1e");
+    }
+
+    SECTION("strings") {
+        CHECK(msgpack_to_bencode("\xa4spam"sv) == "4:spam");
+        CHECK(msgpack_to_bencode("\xd9\x04spam"sv) == "4:spam");
+        CHECK(msgpack_to_bencode("\xc4\x02\xff\x00"sv) == "2:\xff\x00"sv);
+    }
+
+    SECTION("lists") {
+        CHECK(msgpack_to_bencode("\x90"sv) == "le");
+        CHECK(msgpack_to_bencode("\x92\x01\x91\x02"sv) == "li1eli2eee");
+        CHECK(msgpack_to_bencode("\xdc\x00\x01\x01"sv) == "li1ee");
+    }
+
+    SECTION("dict keys are sorted") {
+        CHECK(msgpack_to_bencode("\x82\xa1" "b\x01\xa1" "a\x92\x02\x03"sv) == "d1:ali2ei3ee1:bi1ee");
+    }
+
+    SECTION("errors") {
+        CHECK(msgpack_error("\xc0"sv) == parsing_errc::unsupported_msgpack_value);
+        CHECK(msgpack_error("\xcb\x3f\xf0\x00\x00\x00\x00\x00\x00"sv) == parsing_errc::unsupported_msgpack_value);
+        CHECK(msgpack_error("\xcf\x80\x00\x00\x00\x00\x00\x00\x00"sv) == parsing_errc::integer_overflow);
+        CHECK(msgpack_error("\xc1"sv) == parsing_errc::invalid_msgpack_item);
+        CHECK(msgpack_error("\xa4sp"sv) == parsing_errc::unexpected_eof);
+        CHECK(msgpack_error("\xdd\xff\xff\xff\xff"sv) == parsing_errc::unexpected_eof);
+        CHECK(msgpack_error("\x81\x01\x01"sv) == parsing_errc::expected_string_dict_key);
+        CHECK(msgpack_error("\x82\xa1" "a\x01\xa1" "a\x02"sv) == parsing_errc::duplicate_dict_key);
+        CHECK(msgpack_error("\x91\x91\x91\x90"sv, {.recursion_limit = 2}) == parsing_errc::recursion_depth_exceeded);
+    }
+}
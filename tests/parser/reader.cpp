@@ -0,0 +1,114 @@
+#include <bencode/parsers/reader.hpp>
+
+#include <catch2/catch.hpp>
+
+#include "data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+static parsing_errc reader_error(auto&& f)
+{
+    try {
+        f();
+    }
+    catch (const parsing_error& e) {
+        return e.errc();
+    }
+    FAIL("expected parsing_error");
+    return {};
+}
+
+TEST_CASE("test reader")
+{
+    SECTION("read all tokens") {
+        auto r = reader(example);
+        CHECK(r.next() == reader_token::begin_dict);
+        r.enter_dict();
+        CHECK(r.depth() == 1);
+        CHECK(r.read_string() == "one");
+        CHECK(r.read_integer() == 1);
+        CHECK(r.read_string() == "three");
+        r.enter_list();
+        r.enter_dict();
+        CHECK(r.read_string() == "bar");
+        CHECK(r.read_integer() == 0);
+        CHECK(r.read_string() == "foo");
+        CHECK(r.read_integer() == 0);
+        CHECK(r.next() == reader_token::end);
+        r.leave();
+        r.leave();
+        CHECK(r.read_string() == "two");
+        CHECK(r.next() == reader_token::begin_list);
+        r.enter_list();
+        CHECK(r.read_integer() == 3);
+        CHECK(r.next() == reader_token::string);
+        CHECK(r.read_string() == "foo");
+        CHECK(r.next() == reader_token::integer);
+        CHECK(r.read_integer() == 4);
+        r.leave();
+        r.leave();
+        CHECK(r.depth() == 0);
+        CHECK(r.next() == reader_token::eof);
+        CHECK(r.position() == example.size());
+    }
+
+    SECTION("skip_value") {
+        auto r = reader(example);
+        r.enter_dict();
+        CHECK(r.read_string() == "one");
+        r.skip_value();
+        CHECK(r.read_string() == "three");
+        r.skip_value();
+        CHECK(r.read_string() == "two");
+        r.skip_value();
+        CHECK(r.next() == reader_token::end);
+    }
+
+    SECTION("seek_key") {
+        auto r = reader(sintel_torrent);
+        r.enter_dict();
+        CHECK(r.seek_key("info"));
+        r.enter_dict();
+        CHECK(r.seek_key("name"));
+        CHECK(r.read_string() == "Sintel");
+        CHECK_FALSE(r.seek_key("aaa"));
+        CHECK(r.seek_key("piece length"));
+        CHECK(r.read_integer() == 131072);
+        CHECK_FALSE(r.seek_key("zzz"));
+        CHECK(r.next() == reader_token::end);
+        r.leave();
+        r.leave();
+        CHECK(r.next() == reader_token::eof);
+    }
+
+    SECTION("leave skips remaining values") {
+        auto r = reader("ld1:ai1eei2e3:fooeli3ee"sv);
+        r.enter_list();
+        r.leave();
+        r.enter_list();
+        CHECK(r.read_integer() == 3);
+        r.leave();
+        CHECK(r.next() == reader_token::eof);
+    }
+
+    SECTION("errors") {
+        CHECK(reader_error([] { reader("3:ab"sv).read_string(); }) == parsing_errc::unexpected_eof);
+        CHECK(reader_error([] { reader("i1e"sv).read_string(); }) == parsing_errc::expected_digit);
+        CHECK(reader_error([] { reader("3:abc"sv).read_integer(); }) == parsing_errc::expected_integer_start_token);
+        CHECK(reader_error([] { reader("i01e"sv).read_integer(); }) == parsing_errc::leading_zero);
+        CHECK(reader_error([] { reader("i1e"sv).enter_list(); }) == parsing_errc::expected_value);
+        CHECK(reader_error([] { reader("x"sv).next(); }) == parsing_errc::expected_value);
+        CHECK(reader_error([] { reader("e"sv).next(); }) == parsing_errc::unexpected_end);
+        CHECK(reader_error([] { reader("l5:abc"sv).skip_value(); }) == parsing_errc::unexpected_eof);
+        CHECK(reader_error([] { reader("li1e"sv).skip_value(); }) == parsing_errc::unexpected_eof);
+        CHECK(reader_error([] {
+            auto r = reader("li1e"sv);
+            r.enter_list();
+            r.leave();
+        }) == parsing_errc::unexpected_eof);
+        CHECK(reader_error([] {
+            reader(recursion_limit_list, {.recursion_limit = 10}).skip_value();
+        }) == parsing_errc::recursion_depth_exceeded);
+    }
+}
@@ -37,6 +37,7 @@ TEST_CASE("parse integer", "[integer]")
     constexpr auto negative = "-666"sv;
     constexpr auto zero = "0"sv;
     constexpr auto leading_zero = "000912e"sv;
+    constexpr auto multiple_zeros = "00"sv;
     constexpr auto negative_zero = "-0"sv;
     constexpr auto empty = ""sv;
     constexpr auto minus_only = "-"sv;
@@ -67,6 +68,8 @@ TEST_CASE("parse integer", "[integer]")
     SECTION("leading zeros") {
         invalid_parse_integer_helper<std::int64_t>(leading_zero, parsing_errc::leading_zero);
         invalid_parse_integer_helper<std::size_t>(leading_zero, parsing_errc::leading_zero);
+        invalid_parse_integer_helper<std::int64_t>(multiple_zeros, parsing_errc::leading_zero);
+        invalid_parse_integer_helper<std::size_t>(multiple_zeros, parsing_errc::leading_zero);
     }
     SECTION("positive overflow") {
         invalid_parse_integer_helper<std::int64_t>(positive_overflow, parsing_errc::integer_overflow);
@@ -104,4 +104,76 @@ TEST_CASE("test connect")
         CHECK(ss.str() == map_result);
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("test connect unordered dicts in canonical key order")
+{
+    const auto n = GENERATE(as<std::size_t>{}, 10, 200, 5000);
+    // a long prefix shared by all keys
+    const auto common_prefix = GENERATE(as<std::size_t>{}, 0, 4000);
+
+    // keys with shared prefixes, empty keys and bytes above 0x7f
+    auto make_key = [&](std::size_t i) {
+        std::string key(common_prefix, 'p');
+        key += fmt::format("{}", i % 97);
+        key.append(i % 5, static_cast<char>(0x80 + i % 3));
+        key += fmt::format("{}", i);
+        if (i % 7 == 0) key.resize(common_prefix + i % 3);
+        return key;
+    };
+
+    std::unordered_map<std::string, std::size_t> umap {};
+    std::map<std::string, std::size_t> map {};
+    for (std::size_t i = 0; i < n; ++i) {
+        auto key = make_key(i);
+        umap.emplace(key, i);
+        map.emplace(key, i);
+    }
+    REQUIRE(umap.size() == map.size());
+
+    CHECK(bencode::encode(umap) == bencode::encode(map));
+
+    SECTION("string_view keys") {
+        std::unordered_map<std::string_view, std::size_t> vmap {};
+        for (const auto& [k, v] : map) vmap.emplace(k, v);
+        CHECK(bencode::encode(vmap) == bencode::encode(map));
+    }
+}
+
+TEST_CASE("test connect deeply nested values")
+{
+    SECTION("bview") {
+        constexpr std::size_t depth = 100000;
+        std::string data {};
+        for (std::size_t i = 0; i < depth; ++i) data += (i % 2 == 0) ? "l" : "d1:a";
+        data += "i1e";
+        data.append(depth, 'e');
+
+        auto parser = bencode::descriptor_parser(
+                {.recursion_limit = depth + 1, .value_limit = 4 * depth});
+        auto table = parser.parse(data);
+        REQUIRE(table);
+        CHECK(bencode::encode(table->get_root()) == data);
+    }
+
+    SECTION("basic_bvalue") {
+        constexpr std::size_t depth = 1000;
+        std::string expected = "i1e";
+        auto value = bencode::bvalue(1);
+        for (std::size_t i = 0; i < depth; ++i) {
+            if (i % 2 == 0) {
+                auto l = bencode::bvalue(bencode::btype::list);
+                get_list(l).push_back(std::move(value));
+                value = std::move(l);
+                expected = "l" + expected + "e";
+            }
+            else {
+                auto d = bencode::bvalue(bencode::btype::dict);
+                get_dict(d).emplace("a", std::move(value));
+                value = std::move(d);
+                expected = "d1:a" + expected + "e";
+            }
+        }
+        CHECK(bencode::encode(value) == expected);
+    }
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bencode/bencode.hpp"
+#include "bencode/decode_batch.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+static std::vector<std::string> make_documents(std::size_t n)
+{
+    std::vector<std::string> docs {};
+    docs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 7 == 3)
+            docs.emplace_back("d3:key");                 // truncated
+        else if (i % 5 == 0)
+            docs.emplace_back(sintel_torrent);           // large
+        else
+            docs.push_back("li" + std::to_string(i) + "ee");
+    }
+    return docs;
+}
+
+TEST_CASE("test work_stealing_pool")
+{
+    auto pool = work_stealing_pool(4);
+    CHECK(pool.concurrency() == 4);
+
+    SECTION("every index is processed once") {
+        std::vector<std::atomic<int>> counts(1000);
+        pool.for_each_index(counts.size(), [&](std::size_t worker, std::size_t i) {
+            CHECK(worker < 4);
+            ++counts[i];
+        });
+        for (const auto& c : counts) CHECK(c == 1);
+    }
+
+    SECTION("fewer tasks than workers") {
+        std::atomic<int> count = 0;
+        pool.for_each_index(2, [&](std::size_t, std::size_t) { ++count; });
+        CHECK(count == 2);
+        pool.for_each_index(0, [&](std::size_t, std::size_t) { ++count; });
+        CHECK(count == 2);
+    }
+
+    SECTION("exceptions are rethrown") {
+        std::atomic<int> count = 0;
+        auto f = [&](std::size_t, std::size_t i) {
+            ++count;
+            if (i == 17) throw std::runtime_error("task failed");
+        };
+        CHECK_THROWS_AS(pool.for_each_index(100, f), std::runtime_error);
+        CHECK(count == 100);
+    }
+}
+
+TEST_CASE("test decode_view_batch")
+{
+    const auto docs = make_documents(200);
+    const std::vector<std::string_view> inputs(docs.begin(), docs.end());
+
+    auto pool = work_stealing_pool(3);
+    auto results = decode_view_batch(inputs, {}, pool);
+    REQUIRE(results.size() == inputs.size());
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (i % 7 == 3) {
+            REQUIRE_FALSE(results[i].has_value());
+            CHECK(results[i].error().errc() == parsing_errc::expected_dict_value);
+        }
+        else if (i % 5 == 0) {
+            REQUIRE(results[i].has_value());
+            CHECK(results[i]->get_root() == decode_view(sintel_torrent).get_root());
+        }
+        else {
+            REQUIRE(results[i].has_value());
+            auto root = results[i]->get_root();
+            CHECK(get_integer(get_list(root).front()) == std::int64_t(i));
+        }
+    }
+
+    SECTION("default pool") {
+        auto r = decode_view_batch(inputs);
+        CHECK(r.size() == inputs.size());
+        CHECK(r[1].has_value());
+    }
+}
+
+TEST_CASE("test decode_value_batch")
+{
+    const auto docs = make_documents(200);
+    const std::vector<std::string_view> inputs(docs.begin(), docs.end());
+
+    auto results = decode_value_batch(inputs, {.value_limit = 10});
+    REQUIRE(results.size() == inputs.size());
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (i % 7 == 3) {
+            REQUIRE_FALSE(results[i].has_value());
+            CHECK(results[i].error().errc() == parsing_errc::expected_dict_value);
+        }
+        else if (i % 5 == 0) {
+            // sintel_torrent exceeds the value limit
+            REQUIRE_FALSE(results[i].has_value());
+            CHECK(results[i].error().errc() == parsing_errc::value_limit_exceeded);
+        }
+        else {
+            REQUIRE(results[i].has_value());
+            CHECK(*results[i] == bvalue(btype::list, {std::int64_t(i)}));
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include "bencode/bview.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+namespace bc = bencode;
+
+
+TEST_CASE("test descriptor_table subtree hashes", "[descriptor_table]")
+{
+    const std::string data(sintel_torrent);
+    auto table = bc::decode_view(data);
+    REQUIRE_FALSE(table.has_subtree_hashes());
+
+    const auto before = table.memory_usage();
+    table.compute_subtree_hashes();
+    REQUIRE(table.has_subtree_hashes());
+    CHECK(table.subtree_hashes().size() == table.descriptors().size());
+    CHECK(table.memory_usage().heap_bytes > before.heap_bytes);
+
+    auto root = table.get_root();
+    const auto& info = get_dict(root).at("info");
+
+    SECTION("equal documents in different buffers") {
+        const std::string copy = data;
+        auto other = bc::decode_view(copy);
+        other.compute_subtree_hashes();
+        CHECK(other.subtree_hash(other.get_root()) == table.subtree_hash(root));
+        CHECK(other.subtree_hash(get_dict(other.get_root()).at("info")) == table.subtree_hash(info));
+    }
+
+    SECTION("change detection") {
+        // same info dict, different announce url
+        std::string changed = data;
+        const auto pos = changed.find("announce");
+        REQUIRE(pos != std::string::npos);
+        changed[pos + 12] = 'X';
+        auto other = bc::decode_view(changed);
+        other.compute_subtree_hashes();
+        const auto other_root = other.get_root();
+
+        CHECK(other.subtree_hash(other_root) != table.subtree_hash(root));
+        CHECK(other.subtree_hash(get_dict(other_root).at("info")) == table.subtree_hash(info));
+        CHECK(other.subtree_hash(get_dict(other_root).at("announce"))
+              != table.subtree_hash(get_dict(root).at("announce")));
+    }
+
+    SECTION("end descriptors share the hash of their value") {
+        const auto hashes = table.subtree_hashes();
+        CHECK(hashes.front() == hashes.back());
+    }
+
+    SECTION("seed") {
+        auto other = bc::decode_view(data);
+        other.compute_subtree_hashes(1);
+        CHECK(other.subtree_hash(other.get_root()) != table.subtree_hash(root));
+    }
+}
+
+TEST_CASE("test descriptor_table subtree hashes of small values", "[descriptor_table]")
+{
+    auto hash_of = [](std::string_view data, std::size_t pos = 0) {
+        auto table = bc::decode_view(data);
+        table.compute_subtree_hashes();
+        return table.subtree_hash(table.get_root(pos));
+    };
+
+    CHECK(hash_of("i1e"sv) == hash_of("li1ee"sv, 1));
+    CHECK(hash_of("1:a"sv) == hash_of("d1:a1:ae"sv, 2));
+    CHECK(hash_of("i1e"sv) != hash_of("1:1"sv));
+    CHECK(hash_of("le"sv) != hash_of("de"sv));
+    CHECK(hash_of("l1:ai1ee"sv) != hash_of("li1e1:ae"sv));
+    CHECK(hash_of("l1:ai1ee"sv) == hash_of("ll1:ai1eee"sv, 1));
+    CHECK(hash_of("lli1eei2ee"sv) != hash_of("lli1ei2eee"sv));
+    CHECK(hash_of("d1:ai1e1:bi2ee"sv) != hash_of("d1:bi2e1:ai1ee"sv));
+}
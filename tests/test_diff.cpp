@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/diff.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+namespace bc = bencode;
+
+using op_type = bc::patch_operation_type;
+
+
+static std::string round_trip(std::string_view from, std::string_view to)
+{
+    auto ta = bc::decode_view(from);
+    auto tb = bc::decode_view(to);
+    const auto p = bc::diff(ta.get_root(), tb.get_root());
+    return bc::apply_patch(ta.get_root(), p);
+}
+
+
+TEST_CASE("test diff", "[diff]")
+{
+    SECTION("equal values") {
+        auto ta = bc::decode_view(sintel_torrent);
+        auto tb = bc::decode_view(sintel_torrent);
+        CHECK(bc::diff(ta.get_root(), tb.get_root()).empty());
+    }
+
+    SECTION("dict keys") {
+        auto ta = bc::decode_view("d1:ai1e1:bi2e1:dd1:xi1e1:yi2eee"sv);
+        auto tb = bc::decode_view("d1:bi2e1:ci3e1:dd1:xi1e1:yi5eee"sv);
+        const auto p = bc::diff(ta.get_root(), tb.get_root());
+
+        const bc::patch expected {
+            {op_type::remove,  {"a"}, ""},
+            {op_type::insert,  {"c"}, "i3e"},
+            {op_type::replace, {"d", "y"}, "i5e"},
+        };
+        CHECK(p == expected);
+        CHECK(bc::apply_patch(ta.get_root(), p) == "d1:bi2e1:ci3e1:dd1:xi1e1:yi5eee");
+    }
+
+    SECTION("list edits") {
+        auto ta = bc::decode_view("li1ei2ei3ei4ee"sv);
+        auto tb = bc::decode_view("li1ei9ei4ei5ei6ee"sv);
+        const auto p = bc::diff(ta.get_root(), tb.get_root());
+
+        const bc::patch expected {
+            {op_type::replace, {1u}, "i9e"},
+            {op_type::replace, {2u}, "i4e"},
+            {op_type::replace, {3u}, "i5e"},
+            {op_type::insert,  {4u}, "i6e"},
+        };
+        CHECK(p == expected);
+        CHECK(bc::apply_patch(ta.get_root(), p) == "li1ei9ei4ei5ei6ee");
+    }
+
+    SECTION("common prefix and suffix") {
+        auto ta = bc::decode_view("li1ei2ei3ei4ee"sv);
+        auto tb = bc::decode_view("li1ei4ee"sv);
+        const auto p = bc::diff(ta.get_root(), tb.get_root());
+
+        const bc::patch expected {
+            {op_type::remove, {1u}, ""},
+            {op_type::remove, {1u}, ""},
+        };
+        CHECK(p == expected);
+        CHECK(bc::apply_patch(ta.get_root(), p) == "li1ei4ee");
+    }
+
+    SECTION("type change replaces the value") {
+        auto ta = bc::decode_view("d1:ali1eee"sv);
+        auto tb = bc::decode_view("d1:ad1:bi1eee"sv);
+        const auto p = bc::diff(ta.get_root(), tb.get_root());
+        REQUIRE(p.size() == 1);
+        CHECK(p[0] == bc::patch_operation{op_type::replace, {"a"}, "d1:bi1ee"});
+        CHECK(round_trip("i1e", "3:abc") == "3:abc");
+    }
+
+    SECTION("unsorted keys") {
+        CHECK(round_trip("d1:bi1e1:ai2ee", "d1:ai3e1:ci4ee") == "d1:ai3e1:ci4ee");
+        CHECK(round_trip("d1:ai3e1:ci4ee", "d1:bi1e1:ai2ee") == "d1:ai2e1:bi1ee");
+
+        auto ta = bc::decode_view("ld1:bi1e1:ai2eed1:bi3e1:ai4eee"sv);
+        auto tb = bc::decode_view("ld1:bi1e1:ai2eed1:bi3e1:ai5eee"sv);
+        CHECK(bc::diff(ta.get_root(), ta.get_root()).empty());
+        CHECK(bc::diff(ta.get_root(), tb.get_root()) == bc::patch{{op_type::replace, {1u, "a"}, "i5e"}});
+    }
+
+    SECTION("small change to a torrent") {
+        auto expected = bc::decode_value(sintel_torrent);
+        expected["info"]["name"] = "Sintel (2010)";
+        get_list(expected["announce-list"]).push_back(bc::bvalue(bc::btype::list, {"udp://tracker.example:80"}));
+        get_dict(expected).erase("comment");
+        const auto modified = bc::encode(expected);
+
+        auto ta = bc::decode_view(sintel_torrent);
+        auto tb = bc::decode_view(modified);
+        const auto p = bc::diff(ta.get_root(), tb.get_root());
+
+        CHECK(p.size() == 3);
+        CHECK(bc::encode_patch(p).size() < modified.size() / 4);
+        CHECK(bc::apply_patch(ta.get_root(), p) == modified);
+    }
+}
+
+TEST_CASE("test apply_patch errors", "[diff]")
+{
+    auto t = bc::decode_view("d1:ali1eee"sv);
+    auto root = t.get_root();
+
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::remove, {"b"}, ""}}), std::out_of_range);
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::insert, {"a"}, "i1e"}}), std::invalid_argument);
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::remove, {}, ""}}), std::invalid_argument);
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::replace, {"a", 3u}, "i1e"}}), std::out_of_range);
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::replace, {"a", "x"}, "i1e"}}), bc::bad_bvalue_access);
+    CHECK_THROWS_AS(bc::apply_patch(root, {{op_type::replace, {"a"}, "i1"}}), bc::parsing_error);
+    CHECK(bc::apply_patch(root, {{op_type::replace, {}, "i1e"}}) == "i1e");
+}
+
+TEST_CASE("test encode_patch", "[diff]")
+{
+    const bc::patch p {
+        {op_type::remove,  {"a"}, ""},
+        {op_type::insert,  {"c", 0u}, "i3e"},
+        {op_type::replace, {"d", "y"}, "li5ee"},
+    };
+    const auto encoded = bc::encode_patch(p);
+    CHECK(encoded == "ll1:-l1:aeel1:+l1:ci0eei3eel1:=l1:d1:yeli5eeee");
+
+    auto t = bc::decode_view(encoded);
+    CHECK(bc::decode_patch(t.get_root()) == p);
+
+    auto invalid = bc::decode_view("ll1:?leee"sv);
+    CHECK_THROWS_AS(bc::decode_patch(invalid.get_root()), std::invalid_argument);
+
+    SECTION("malformed patches") {
+        constexpr std::string_view malformed[] = {
+            "i1e", "li1ee", "llee", "ll1:+ee", "ll1:+leee", "ll1:-lei1eee",
+            "ll1:=i1ei1eee", "ll1:-li1ei-1eeee", "ll1:-lleeee",
+        };
+        for (const auto data : malformed) {
+            auto m = bc::decode_view(data);
+            CHECK_THROWS_AS(bc::decode_patch(m.get_root()), bc::bad_bview_access);
+        }
+    }
+}
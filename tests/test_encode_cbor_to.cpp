@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "bencode/bencode.hpp"
+#include "bencode/events/encode_cbor_to.hpp"
+#include "bencode/events/encode_to.hpp"
+#include "bencode/parsers/cbor_parser.hpp"
+#include "bencode/traits/all.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace std::string_literals;
+using namespace bencode;
+
+static std::string to_hex(std::string_view s)
+{
+    std::string out {};
+    for (unsigned char c : s) {
+        out.push_back("0123456789abcdef"[c >> 4]);
+        out.push_back("0123456789abcdef"[c & 0x0F]);
+    }
+    return out;
+}
+
+template <typename T>
+static std::string cbor_hex(const T& value)
+{
+    std::string out {};
+    auto consumer = events::encode_cbor_to(std::back_inserter(out));
+    connect(consumer, value);
+    return to_hex(out);
+}
+
+static std::string bencode_to_cbor(std::string_view data)
+{
+    std::string out {};
+    auto consumer = events::encode_cbor_to(std::back_inserter(out));
+    auto parser = push_parser();
+    REQUIRE(parser.parse(consumer, data));
+    return out;
+}
+
+static std::string cbor_to_bencode(std::string_view data)
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = cbor_parser();
+    REQUIRE(parser.parse(consumer, data));
+    return out;
+}
+
+TEST_CASE("test encode_cbor_to")
+{
+    SECTION("integers") {
+        CHECK(cbor_hex(0) == "00");
+        CHECK(cbor_hex(23) == "17");
+        CHECK(cbor_hex(24) == "1818");
+        CHECK(cbor_hex(256) == "190100");
+        CHECK(cbor_hex(65536) == "1a00010000");
+        CHECK(cbor_hex(std::int64_t(1) << 32) == "1b0000000100000000");
+        CHECK(cbor_hex(-1) == "20");
+        CHECK(cbor_hex(-25) == "3818");
+        CHECK(cbor_hex(-257) == "390100");
+        CHECK(cbor_hex(std::numeric_limits<std::int64_t>::min()) == "3b7fffffffffffffff");
+    }
+
+    SECTION("strings") {
+        CHECK(cbor_hex("spam"s) == "647370616d");
+        CHECK(cbor_hex("\xff\x00"s) == "42ff00");
+    }
+
+    SECTION("unknown size uses indefinite length") {
+        CHECK(to_hex(bencode_to_cbor("li1ee")) == "9f01ff");
+        CHECK(to_hex(bencode_to_cbor("d1:ai1ee")) == "bf616101ff");
+    }
+
+    SECTION("known size uses definite length") {
+        CHECK(cbor_hex(std::vector<int>{1, 2}) == "820102");
+
+        auto parser = descriptor_parser();
+        auto table = parser.parse("d1:ai1e1:bli2eee"sv);
+        REQUIRE(table);
+        CHECK(cbor_hex(table->get_root()) == "a2616101616281" "02");
+    }
+}
+
+TEST_CASE("test cbor round trip")
+{
+    CHECK(cbor_to_bencode(bencode_to_cbor(example)) == example);
+    CHECK(cbor_to_bencode(bencode_to_cbor(sintel_torrent)) == sintel_torrent);
+
+    auto parser = descriptor_parser();
+    auto table = parser.parse(sintel_torrent);
+    REQUIRE(table);
+    std::string cbor {};
+    auto consumer = events::encode_cbor_to(std::back_inserter(cbor));
+    connect(consumer, table->get_root());
+    CHECK(cbor_to_bencode(cbor) == sintel_torrent);
+}
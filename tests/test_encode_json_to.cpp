@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include "bencode/bencode.hpp"
+#include "bencode/events/encode_json_to.hpp"
+#include "bencode/traits/all.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace std::string_literals;
+using namespace bencode;
+
+static std::string to_json(std::string_view data,
+                           json_binary_encoding binary = json_binary_encoding::escape)
+{
+    std::string out {};
+    auto consumer = events::encode_json_to(out, binary);
+    auto parser = push_parser();
+    REQUIRE(parser.parse(consumer, data));
+    return out;
+}
+
+TEST_CASE("test encode_json_to")
+{
+    SECTION("compact output") {
+        CHECK(to_json(example) ==
+              R"({"one":1,"three":[{"bar":0,"foo":0}],"two":[3,"foo",4]})");
+    }
+
+    SECTION("empty structures") {
+        CHECK(to_json("le") == "[]");
+        CHECK(to_json("de") == "{}");
+        CHECK(to_json("ldelee") == "[{},[]]");
+    }
+
+    SECTION("escaping") {
+        std::string out {};
+        auto consumer = events::encode_json_to(out);
+        connect(consumer, std::string("a\"b\\c\nd\x01 tail of more than sixteen chars\t"));
+        CHECK(out == R"("a\"b\\c\nd\u0001 tail of more than sixteen chars\t")");
+    }
+
+    SECTION("utf-8 strings are copied verbatim") {
+        std::string out {};
+        auto consumer = events::encode_json_to(out, json_binary_encoding::hex);
+        connect(consumer, std::string("caf\xc3\xa9 \xe2\x82\xac"));
+        CHECK(out == "\"caf\xc3\xa9 \xe2\x82\xac\"");
+    }
+
+    SECTION("binary strings") {
+        const auto binary = std::string("\xff\x00\x10\xc3"sv);
+
+        std::string out {};
+        auto escape = events::encode_json_to(out);
+        connect(escape, binary);
+        CHECK(out == R"("\u00ff\u0000\u0010\u00c3")");
+
+        out.clear();
+        auto hex = events::encode_json_to(out, json_binary_encoding::hex);
+        connect(hex, binary);
+        CHECK(out == R"("ff0010c3")");
+
+        out.clear();
+        auto base64 = events::encode_json_to(out, json_binary_encoding::base64);
+        connect(base64, binary);
+        CHECK(out == R"("/wAQww==")");
+    }
+
+    SECTION("base64 padding") {
+        std::string out {};
+        auto consumer = events::encode_json_to(out, json_binary_encoding::base64);
+        connect(consumer, std::vector<std::string>{"\xff"s, "\xff\xfe"s, "\xff\xfe\xfd"s});
+        CHECK(out == R"(["/w==","//4=","//79"])");
+    }
+
+    SECTION("append to existing buffer") {
+        std::string out = "prefix ";
+        auto consumer = events::encode_json_to(out);
+        connect(consumer, std::vector<int>{1, 2});
+        CHECK(out == "prefix [1,2]");
+    }
+}
+
+TEST_CASE("test utf-8 validation")
+{
+    CHECK(detail::is_valid_utf8(""));
+    CHECK(detail::is_valid_utf8("ascii only string longer than sixteen bytes"));
+    CHECK(detail::is_valid_utf8("\xf0\x9f\x98\x80 emoji after which more ascii follows"));
+    CHECK_FALSE(detail::is_valid_utf8("overlong \xc0\xaf sequence in a longer string"));
+    CHECK_FALSE(detail::is_valid_utf8("surrogate \xed\xa0\x80"));
+    CHECK_FALSE(detail::is_valid_utf8("truncated \xe2\x82"));
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "bencode/bencode.hpp"
+#include "bencode/events/encode_msgpack_to.hpp"
+#include "bencode/events/encode_to.hpp"
+#include "bencode/parsers/msgpack_parser.hpp"
+#include "bencode/traits/all.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace std::string_literals;
+using namespace bencode;
+
+static std::string to_hex(std::string_view s)
+{
+    std::string out {};
+    for (unsigned char c : s) {
+        out.push_back("0123456789abcdef"[c >> 4]);
+        out.push_back("0123456789abcdef"[c & 0x0F]);
+    }
+    return out;
+}
+
+template <typename T>
+static std::string msgpack_hex(const T& value)
+{
+    std::string out {};
+    auto consumer = events::encode_msgpack_to(out);
+    connect(consumer, value);
+    return to_hex(out);
+}
+
+static std::string bencode_to_msgpack(std::string_view data)
+{
+    std::string out {};
+    auto consumer = events::encode_msgpack_to(out);
+    auto parser = push_parser();
+    REQUIRE(parser.parse(consumer, data));
+    return out;
+}
+
+static std::string msgpack_to_bencode(std::string_view data)
+{
+    std::string out {};
+    auto consumer = events::encode_to(std::back_inserter(out));
+    auto parser = msgpack_parser();
+    REQUIRE(parser.parse(consumer, data));
+    return out;
+}
+
+TEST_CASE("test encode_msgpack_to")
+{
+    SECTION("integers") {
+        CHECK(msgpack_hex(127) == "7f");
+        CHECK(msgpack_hex(128) == "cc80");
+        CHECK(msgpack_hex(256) == "cd0100");
+        CHECK(msgpack_hex(65536) == "ce00010000");
+        CHECK(msgpack_hex(std::int64_t(1) << 32) == "cf0000000100000000");
+        CHECK(msgpack_hex(-1) == "ff");
+        CHECK(msgpack_hex(-32) == "e0");
+        CHECK(msgpack_hex(-33) == "d0df");
+        CHECK(msgpack_hex(-129) == "d1ff7f");
+        CHECK(msgpack_hex(-32769) == "d2ffff7fff");
+        CHECK(msgpack_hex(std::numeric_limits<std::int64_t>::min()) == "d38000000000000000");
+    }
+
+    SECTION("strings") {
+        CHECK(msgpack_hex("spam"s) == "a47370616d");
+        CHECK(msgpack_hex(std::string(32, 'a')).starts_with("d920"));
+        CHECK(msgpack_hex("\xff\x00"s) == "c402ff00");
+    }
+
+    SECTION("unknown size is patched") {
+        CHECK(to_hex(bencode_to_msgpack("li1ei2ee")) == "dd000000020102");
+        CHECK(to_hex(bencode_to_msgpack("d1:ai1ee")) == "df00000001a16101");
+    }
+
+    SECTION("known size") {
+        CHECK(msgpack_hex(std::vector<int>{1, 2}) == "920102");
+    }
+
+    SECTION("sizes larger than 32 bits") {
+        std::string out {};
+        auto consumer = events::encode_msgpack_to(out);
+        CHECK_THROWS_AS(consumer.begin_list(std::size_t(1) << 32), std::length_error);
+        CHECK_THROWS_AS(consumer.begin_dict(std::size_t(1) << 32), std::length_error);
+        CHECK_NOTHROW(consumer.begin_list(0xFFFFFFFF));
+    }
+}
+
+TEST_CASE("test msgpack round trip")
+{
+    CHECK(msgpack_to_bencode(bencode_to_msgpack(example)) == example);
+    CHECK(msgpack_to_bencode(bencode_to_msgpack(sintel_torrent)) == sintel_torrent);
+
+    auto parser = descriptor_parser();
+    auto table = parser.parse(sintel_torrent);
+    REQUIRE(table);
+    std::string msgpack {};
+    auto consumer = events::encode_msgpack_to(msgpack);
+    connect(consumer, table->get_root());
+    CHECK(msgpack_to_bencode(msgpack) == sintel_torrent);
+}
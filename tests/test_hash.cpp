@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/events/hash_to.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+namespace bc = bencode;
+
+
+TEST_CASE("test byte_hasher", "[hash]")
+{
+    const std::string data(sintel_torrent);
+    const auto expected = bc::detail::hash_bytes(data);
+
+    SECTION("independent of how the input is split") {
+        for (std::size_t chunk : {1, 3, 7, 16, 17, 100}) {
+            bc::detail::byte_hasher h {};
+            for (std::size_t i = 0; i < data.size(); i += chunk)
+                h.update(std::string_view(data).substr(i, chunk));
+            CHECK(h.digest() == expected);
+        }
+        bc::detail::byte_hasher h {};
+        for (char c : data) h.update(c);
+        CHECK(h.digest() == expected);
+    }
+
+    SECTION("seed and input change the result") {
+        CHECK(bc::detail::hash_bytes(data, 1) != expected);
+        CHECK(bc::detail::hash_bytes(""sv) != bc::detail::hash_bytes("\0"sv));
+        CHECK(bc::detail::hash_bytes("a"sv) != bc::detail::hash_bytes("b"sv));
+    }
+
+    SECTION("constant evaluation") {
+        constexpr auto h = bc::detail::hash_bytes("i1e"sv);
+        CHECK(h == bc::detail::hash_bytes(std::string("i1e")));
+    }
+}
+
+TEST_CASE("test hash of bview and bvalue", "[hash]")
+{
+    const std::string data(sintel_torrent);
+    auto table = bc::decode_view(data);
+    auto root = table.get_root();
+    auto value = bc::decode_value(data);
+
+    SECTION("bview hashes its bencoded data") {
+        CHECK(bc::hash(root) == bc::detail::hash_bytes(data));
+        CHECK(bc::hash(root, 42) == bc::detail::hash_bytes(data, 42));
+        CHECK(bc::hash(get_dict(root)) == bc::hash(root));
+    }
+
+    SECTION("bvalue hashes its encoding") {
+        CHECK(bc::hash(value) == bc::detail::hash_bytes(bc::encode(value)));
+        CHECK(bc::hash(value) == bc::hash(root));
+        CHECK(bc::hash(value, 42) == bc::hash(root, 42));
+    }
+
+    SECTION("equal values in different buffers") {
+        const std::string copy = data;
+        auto other = bc::decode_view(copy);
+        CHECK(std::hash<bc::bview>{}(root) == std::hash<bc::bview>{}(other.get_root()));
+    }
+
+    SECTION("modified value") {
+        auto modified = value;
+        modified["info"]["name"] = "Sintel 2";
+        CHECK(bc::hash(modified) != bc::hash(value));
+    }
+
+    SECTION("hash_to matches encode_to") {
+        auto consumer = bc::events::hash_to(7);
+        bc::connect(consumer, value);
+        CHECK(consumer.value() == bc::detail::hash_bytes(data, 7));
+    }
+
+    SECTION("uninitialized") {
+        CHECK(bc::hash(bc::bview{}) == bc::hash(bc::bvalue{}));
+    }
+
+    SECTION("values with unsorted keys hash their bencoded data") {
+        const std::string unsorted = "ld1:bi1e1:ai2eei3ee";
+        const std::string copy = unsorted;
+        auto t1 = bc::decode_view(unsorted);
+        auto t2 = bc::decode_view(copy);
+        REQUIRE_FALSE(t1.get_root().is_canonical());
+        REQUIRE(t1.get_root() == t2.get_root());
+
+        CHECK(bc::hash(t1.get_root()) == bc::hash(t2.get_root()));
+        CHECK(bc::hash(t1.get_root(), 42) == bc::detail::hash_bytes(unsorted, 42));
+        CHECK(bc::hash(get_list(t1.get_root())) == bc::hash(t1.get_root()));
+    }
+}
+
+TEST_CASE("test bview and bvalue as unordered container keys", "[hash]")
+{
+    const auto data = "l3:abci1eli1ei2eed1:ai1eei1e3:abce"sv;
+    auto table = bc::decode_view(data);
+    const auto& l = get_list(table.get_root());
+
+    std::unordered_set<bc::bview> views(l.begin(), l.end());
+    CHECK(views.size() == 4);
+
+    std::unordered_map<bc::bvalue, int> counts {};
+    for (const auto& v : l) ++counts[bc::bvalue(v)];
+    CHECK(counts.size() == 4);
+    CHECK(counts[bc::bvalue("abc")] == 2);
+    CHECK(counts[bc::bvalue(1)] == 2);
+
+    std::unordered_set<bc::string_bview> strings {};
+    strings.insert(get_string(l[0]));
+    CHECK(strings.contains(get_string(l[5])));
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/lazy_bvalue.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode::literals;
+namespace bc = bencode;
+
+
+TEST_CASE("test key_literal", "[key_literal]")
+{
+    constexpr auto key = "piece length"_key;
+
+    SECTION("precomputed at compile time") {
+        static_assert(key.size() == 12);
+        static_assert(key.view() == "piece length");
+        static_assert(key.hash() == bc::detail::hash_bytes("piece length"));
+        static_assert(key.prefix() == 0x656c206563656970ull);
+        static_assert(""_key.prefix() == 0);
+        static_assert("ab"_key.prefix() == 0x6261);
+        CHECK(key.hash() == bc::detail::hash_bytes(std::string("piece length")));
+    }
+
+    SECTION("matches") {
+        CHECK(key.matches("piece length"));
+        CHECK(key == "piece length"sv);
+        CHECK_FALSE(key.matches("piece lengths"));
+        CHECK_FALSE(key.matches("piece_length"));
+        CHECK_FALSE(key.matches("piece lengtH"));
+        CHECK_FALSE(key.matches(""));
+        CHECK("abc"_key.matches("abc"));
+        CHECK_FALSE("abc"_key.matches("abd"));
+        CHECK(""_key.matches(""));
+    }
+}
+
+TEST_CASE("test key_literal lookups", "[key_literal]")
+{
+    auto table = bc::decode_view(sintel_torrent);
+    const auto root = table.get_root();
+    const auto& d = get_dict(root);
+    const auto info = d.at("info"_key);
+
+    SECTION("dict_bview") {
+        CHECK(d.find("announce"_key) == d.find("announce"));
+        CHECK(d.find("missing"_key) == d.end());
+        CHECK(d.contains("comment"_key));
+        CHECK_FALSE(d.contains("comments"_key));
+        CHECK(get_dict(info).at("piece length"_key) == get_dict(info).at("piece length"));
+        CHECK_THROWS_AS(d.at("missing"_key), std::out_of_range);
+    }
+
+    SECTION("basic_bvalue") {
+        auto value = bc::decode_value(sintel_torrent);
+        const auto& const_value = value;
+
+        CHECK(value.at("announce"_key) == value.at("announce"));
+        CHECK(const_value.at("info"_key).at("piece length"_key) == value.at("info").at("piece length"));
+        CHECK(value.contains("comment"_key));
+        CHECK_FALSE(value.contains("missing"_key));
+        CHECK_THROWS_AS(value.at("missing"_key), std::out_of_range);
+
+        value["comment"_key] = "changed";
+        CHECK(value.at("comment") == "changed");
+        value["new"_key] = 1;
+        CHECK(value.at("new") == 1);
+
+        bc::bvalue empty {};
+        empty["a"_key] = 2;
+        CHECK(bc::encode(empty) == "d1:ai2ee");
+
+        bc::bvalue list(bc::btype::list);
+        CHECK_THROWS_AS(list["a"_key], bc::bad_bvalue_access);
+        CHECK_THROWS_AS(list.at("a"_key), bc::bad_bvalue_access);
+    }
+
+    SECTION("string_view interfaces") {
+        bc::lazy_bvalue lazy(root);
+        CHECK(lazy.contains("info"_key));
+    }
+}
@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/lazy_bvalue.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+
+TEST_CASE("test bview bencoded_view of nested values")
+{
+    const auto data = "l3:abci22eli1eei0ei-15ed1:ai1eee"sv;
+    auto table = decode_view(data);
+    auto root = table.get_root();
+    const auto& l = get_list(root);
+
+    CHECK(l[0].bencoded_view() == "3:abc");
+    CHECK(l[1].bencoded_view() == "i22e");
+    CHECK(l[2].bencoded_view() == "li1ee");
+    CHECK(l[3].bencoded_view() == "i0e");
+    CHECK(l[4].bencoded_view() == "i-15e");
+    CHECK(l[5].bencoded_view() == "d1:ai1ee");
+}
+
+TEST_CASE("test lazy_bvalue")
+{
+    auto table = decode_view(sintel_torrent);
+    auto root = table.get_root();
+    auto value = lazy_bvalue(root);
+
+    SECTION("unmodified value encodes to the input") {
+        CHECK(value.is_view());
+        CHECK(value.type() == bencode_type::dict);
+        CHECK(value.size() == get_dict(root).size());
+        CHECK(value.contains("info"));
+        CHECK(encode(value) == sintel_torrent);
+        CHECK(value.materialized_count() == 0);
+    }
+
+    SECTION("modifying a field materializes only its path") {
+        value["info"]["name"] = "Sintel (2010)";
+
+        CHECK_FALSE(value.is_view());
+        CHECK(value.materialized_count() == 2);
+        CHECK(value.at("announce").is_view());
+        CHECK(value["info"].at("pieces").is_view());
+        CHECK_FALSE(value["info"]["name"].is_view());
+
+        auto expected = decode_value(sintel_torrent);
+        expected["info"]["name"] = "Sintel (2010)";
+        CHECK(encode(value) == encode(expected));
+        CHECK(value.to_value() == expected);
+    }
+
+    SECTION("insert and erase") {
+        value["comment"] = "hello";
+        CHECK(value.erase("created by") == 1);
+        CHECK(value.erase("missing") == 0);
+
+        auto expected = decode_value(sintel_torrent);
+        expected["comment"] = "hello";
+        get_dict(expected).erase("created by");
+        CHECK(encode(value) == encode(expected));
+    }
+
+    SECTION("lists") {
+        auto& announce_list = value["announce-list"];
+        const auto n = announce_list.size();
+        announce_list.push_back(bvalue(btype::list));
+        announce_list[n].push_back(bvalue("udp://tracker.example.com:80"));
+        CHECK(announce_list.size() == n + 1);
+        CHECK(announce_list.at(0).is_view());
+        CHECK_THROWS_AS(announce_list.at(n + 1), std::out_of_range);
+
+        auto expected = decode_value(sintel_torrent);
+        auto tier = bvalue(btype::list);
+        get_list(tier).push_back("udp://tracker.example.com:80");
+        get_list(expected["announce-list"]).push_back(std::move(tier));
+        CHECK(encode(value) == encode(expected));
+    }
+
+    SECTION("insert and erase list elements") {
+        auto& announce_list = value["announce-list"];
+        const auto n = announce_list.size();
+        announce_list.insert(0, bvalue("udp://tracker.example.com:80"));
+        announce_list.erase(n);
+        CHECK(announce_list.size() == n);
+        CHECK(announce_list.at(1).is_view());
+        CHECK_THROWS_AS(announce_list.erase(n), std::out_of_range);
+        CHECK_THROWS_AS(announce_list.insert(n + 1, bvalue(1)), std::out_of_range);
+
+        auto expected = decode_value(sintel_torrent);
+        auto& l = get_list(expected["announce-list"]);
+        l.pop_back();
+        l.insert(l.begin(), "udp://tracker.example.com:80");
+        CHECK(encode(value) == encode(expected));
+    }
+
+    SECTION("replace a subtree by a view") {
+        auto other = decode_view(example);
+        value["info"] = other.get_root();
+        CHECK(value["info"].is_view());
+        CHECK(encode(value["info"]) == example);
+    }
+
+    SECTION("uninitialized value") {
+        lazy_bvalue v {};
+        CHECK(v.type() == bencode_type::uninitialized);
+        v["a"] = 1;
+        CHECK(v.type() == bencode_type::dict);
+        CHECK(encode(v) == "d1:ai1ee");
+    }
+
+    SECTION("errors") {
+        CHECK_THROWS_AS(value.at("missing"), std::out_of_range);
+        CHECK_THROWS_AS(value.at(0), bad_bvalue_access);
+        CHECK_THROWS_AS(value.at("announce")["x"], bad_bvalue_access);
+        CHECK_THROWS_AS(value.at("announce").size(), bad_bvalue_access);
+    }
+
+    SECTION("events without raw support") {
+        value["info"]["name"] = "Sintel (2010)";
+        auto expected = decode_value(sintel_torrent);
+        expected["info"]["name"] = "Sintel (2010)";
+
+        auto consumer = events::to_bvalue{};
+        connect(consumer, value);
+        CHECK(consumer.value() == expected);
+    }
+
+    SECTION("deeply nested materialized lists") {
+        constexpr std::size_t depth = 10000;
+        lazy_bvalue deep {};
+        lazy_bvalue* current = &deep;
+        for (std::size_t i = 0; i < depth; ++i) {
+            current->push_back(lazy_bvalue(bvalue(btype::list)));
+            current = &current->at(0);
+        }
+
+        CHECK(deep.materialized_count() == depth);
+        CHECK(encode(deep) == std::string(depth + 1, 'l') + std::string(depth + 1, 'e'));
+    }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/bencode.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+TEST_CASE("test descriptor_table memory_usage")
+{
+    auto table = decode_view(example);
+    auto m = table.memory_usage();
+
+    // d 3:one i1e 5:three l d 3:bar i0e 3:foo i0e e e 3:two l i3e 3:foo i4e e e
+    CHECK(m.integer_count == 5);
+    CHECK(m.string_count == 1);
+    CHECK(m.list_count == 2);
+    CHECK(m.dict_count == 2);
+    CHECK(m.node_count == 10);
+    CHECK(m.allocation_count == 1);
+    CHECK(m.heap_bytes == table.descriptors().capacity() * sizeof(descriptor));
+    CHECK(m.total_bytes == sizeof(descriptor_table) + m.heap_bytes);
+
+    SECTION("single value") {
+        auto integer = decode_view("i1e"sv);
+        auto mi = integer.memory_usage();
+        CHECK(mi.integer_count == 1);
+        CHECK(mi.node_count == 1);
+    }
+
+    SECTION("empty table") {
+        auto empty = descriptor_table();
+        CHECK(empty.memory_usage().node_count == 0);
+        CHECK(empty.memory_usage().allocation_count == 0);
+        CHECK(empty.memory_usage().total_bytes == sizeof(descriptor_table));
+    }
+}
+
+TEST_CASE("test basic_bvalue memory_usage")
+{
+    SECTION("node counts") {
+        auto value = decode_value(example);
+        auto m = value.memory_usage();
+        CHECK(m.integer_count == 5);
+        CHECK(m.string_count == 1);
+        CHECK(m.list_count == 2);
+        CHECK(m.dict_count == 2);
+        CHECK(m.node_count == 10);
+        CHECK(m.total_bytes == sizeof(bvalue) + m.heap_bytes);
+    }
+
+    SECTION("primitive values") {
+        CHECK(bvalue(1).memory_usage().heap_bytes == 0);
+        CHECK(bvalue(1).memory_usage().total_bytes == sizeof(bvalue));
+        CHECK(bvalue("short").memory_usage().allocation_count == 0);
+
+        auto long_string = bvalue(std::string(1000, 'x'));
+        auto m = long_string.memory_usage();
+        CHECK(m.allocation_count == 1);
+        CHECK(m.heap_bytes >= 1001);
+        CHECK(bvalue().memory_usage().node_count == 0);
+    }
+
+    SECTION("list") {
+        auto list = bvalue(btype::list, {1, 2, 3});
+        auto m = list.memory_usage();
+        CHECK(m.node_count == 4);
+        CHECK(m.allocation_count == 1);
+        CHECK(m.heap_bytes == get_list(list).capacity() * sizeof(bvalue));
+    }
+
+    SECTION("dict") {
+        auto dict = bvalue(btype::dict, {{"a", 1}, {"b", 2}});
+        auto m = dict.memory_usage();
+        CHECK(m.node_count == 3);
+        CHECK(m.allocation_count == 2);
+        CHECK(m.heap_bytes >= 2 * sizeof(bvalue::dict_value_type));
+    }
+}
+
+TEST_CASE("test counting_allocator")
+{
+    using counting_bvalue = basic_bvalue<counting_bvalue_policy>;
+
+    thread_allocation_stats() = {};
+    {
+        auto value = decode_value<counting_bvalue_policy>(sintel_torrent);
+        const auto& stats = thread_allocation_stats();
+        CHECK(stats.allocation_count > 0);
+        CHECK(stats.bytes_in_use() > 0);
+        CHECK(stats.peak_bytes >= stats.bytes_in_use());
+
+        // the estimate matches the allocator for the retained memory
+        auto m = value.memory_usage();
+        CHECK(m.heap_bytes == stats.bytes_in_use());
+
+        auto copy = counting_bvalue(value);
+        CHECK(copy == value);
+    }
+    const auto& stats = thread_allocation_stats();
+    CHECK(stats.bytes_in_use() == 0);
+    CHECK(stats.allocation_count == stats.deallocation_count);
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "bencode/traits/all.hpp"
+#include "bencode/bencode.hpp"
+#include "bencode/merge.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+namespace bc = bencode;
+
+
+static std::string merge(std::string_view base, std::string_view overlay, bc::merge_options options = {})
+{
+    auto tb = bc::decode_view(base);
+    auto to = bc::decode_view(overlay);
+    return bc::merge(get_dict(tb.get_root()), get_dict(to.get_root()), options);
+}
+
+
+TEST_CASE("test merge", "[merge]")
+{
+    SECTION("disjoint and shared keys") {
+        CHECK(merge("de", "de") == "de");
+        CHECK(merge("d1:ai1ee", "de") == "d1:ai1ee");
+        CHECK(merge("de", "d1:ai1ee") == "d1:ai1ee");
+        CHECK(merge("d1:ai1e1:ci3ee", "d1:bi2e1:di4ee") == "d1:ai1e1:bi2e1:ci3e1:di4ee");
+        CHECK(merge("d1:ai1e1:bi2ee", "d1:bi5ee") == "d1:ai1e1:bi5ee");
+    }
+
+    SECTION("nested dicts") {
+        const auto base    = "d1:ad1:xi1e1:yi2ee1:bli1eee"sv;
+        const auto overlay = "d1:ad1:yi3e1:zi4ee1:bli2eee"sv;
+
+        CHECK(merge(base, overlay) == "d1:ad1:xi1e1:yi3e1:zi4ee1:bli2eee");
+        CHECK(merge(base, overlay, {.recursive = false}) == "d1:ad1:yi3e1:zi4ee1:bli2eee");
+    }
+
+    SECTION("conflict policies") {
+        const auto base    = "d1:ai1e1:bi2e1:cd1:xi1eee"sv;
+        const auto overlay = "d1:ai1e1:bi3e1:cd1:xi2eee"sv;
+
+        CHECK(merge(base, overlay, {.conflict = bc::merge_conflict_policy::overlay_wins})
+              == "d1:ai1e1:bi3e1:cd1:xi2eee");
+        CHECK(merge(base, overlay, {.conflict = bc::merge_conflict_policy::base_wins})
+              == "d1:ai1e1:bi2e1:cd1:xi1eee");
+        CHECK_THROWS_AS(merge(base, overlay, {.conflict = bc::merge_conflict_policy::error}),
+                        bc::merge_conflict_error);
+        // equal values do not conflict
+        CHECK(merge("d1:ai1ee", "d1:ai1ee", {.conflict = bc::merge_conflict_policy::error}) == "d1:ai1ee");
+
+        try {
+            merge("d1:ad1:xi1eee", "d1:ad1:xi2eee", {.conflict = bc::merge_conflict_policy::error});
+            FAIL("expected merge_conflict_error");
+        }
+        catch (const bc::merge_conflict_error& e) {
+            CHECK(e.key() == "x");
+        }
+    }
+
+    SECTION("unsorted keys produce canonical output") {
+        CHECK(merge("d1:bi2e1:ai1ee", "d1:ci3ee") == "d1:ai1e1:bi2e1:ci3ee");
+        CHECK(merge("d1:ai1ee", "d1:ci3e1:bd1:yi1e1:xi2eee") == "d1:ai1e1:bd1:xi2e1:yi1ee1:ci3ee");
+        CHECK(merge("d1:ali1ed1:bi1e1:ai2eeee", "de") == "d1:ali1ed1:ai2e1:bi1eeee");
+    }
+
+    SECTION("template with overrides matches decode and merge") {
+        const auto overlay = "d7:comment6:tenant4:infod4:name7:renamedee"sv;
+
+        auto expected = bc::decode_value(sintel_torrent);
+        expected["comment"] = "tenant";
+        expected["info"]["name"] = "renamed";
+
+        CHECK(merge(sintel_torrent, overlay) == bc::encode(expected));
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string_view>
+
+#include "bencode/ondemand.hpp"
+
+#include "parser/data.hpp"
+
+using namespace std::string_view_literals;
+using namespace bencode;
+
+TEST_CASE("test ondemand_document")
+{
+    SECTION("nested lookup") {
+        auto doc = ondemand_document(sintel_torrent);
+        CHECK(doc.root().is_dict());
+        CHECK(doc["info"]["name"].as_string() == "Sintel");
+        CHECK(doc["info"]["piece length"].as_integer() == 131072);
+        CHECK(doc["info"].contains("files"));
+        CHECK_FALSE(doc["info"].contains("md5sum"));
+        CHECK_FALSE(doc.root().find("zzz").has_value());
+    }
+
+    SECTION("list elements") {
+        auto doc = ondemand_document(example);
+        auto two = doc["two"];
+        CHECK(two.is_list());
+        CHECK(two.size() == 3);
+        CHECK(two[0].as_integer() == 3);
+        CHECK(two[1].as_string() == "foo");
+        CHECK(two[2].as_integer() == 4);
+        CHECK(doc["three"][0]["foo"].as_integer() == 0);
+        CHECK(doc.root().size() == 3);
+    }
+
+    SECTION("raw") {
+        auto doc = ondemand_document(example);
+        CHECK(doc.root().raw() == example);
+        CHECK(doc["two"].raw() == "li3e3:fooi4ee");
+        CHECK(doc["one"].raw() == "i1e");
+    }
+
+    SECTION("errors") {
+        auto doc = ondemand_document(example);
+        CHECK_THROWS_AS(doc["one"].as_string(), bad_bview_access);
+        CHECK_THROWS_AS(doc["one"]["x"], bad_bview_access);
+        CHECK_THROWS_AS(doc["one"].size(), bad_bview_access);
+        CHECK_THROWS_AS(doc["two"][3], std::out_of_range);
+        CHECK_THROWS_AS(doc["missing"], std::out_of_range);
+
+        auto truncated = ondemand_document("d3:onei1e5:three"sv);
+        CHECK(truncated["one"].as_integer() == 1);
+        CHECK_THROWS_AS(truncated["two"], parsing_error);
+
+        try {
+            (void) ondemand_document("d1:ai1e1:bi1x"sv)["b"].as_integer();
+            FAIL("expected parsing_error");
+        }
+        catch (const parsing_error& e) {
+            CHECK(e.position() == 10);
+        }
+    }
+}